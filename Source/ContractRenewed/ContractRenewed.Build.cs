@@ -14,6 +14,9 @@ public class ContractRenewed : ModuleRules
 		// Gameplay Ability System
 		PublicDependencyModuleNames.AddRange(new string[] {"GameplayAbilities", "GameplayTags", "GameplayTasks"});
 
+		// AI, public for the perception interfaces characters implement
+		PublicDependencyModuleNames.AddRange(new string[] {"AIModule"});
+
 		// Automation Dependencies
 		PublicDependencyModuleNames.AddRange(new string[] {"UnrealEd"});
 		
@@ -21,7 +24,10 @@ public class ContractRenewed : ModuleRules
 		PrivateDependencyModuleNames.AddRange(new string[] {"Slate", "SlateCore"});
 		
 		// AI
-		PrivateDependencyModuleNames.AddRange(new string[] {"AIModule", "NavigationSystem"});
+		PrivateDependencyModuleNames.AddRange(new string[] {"NavigationSystem"});
+		
+		// Runtime meshes
+		PrivateDependencyModuleNames.AddRange(new string[] {"MeshDescription", "StaticMeshDescription"});
 		
 		// Uncomment if you are using online features
 		// PrivateDependencyModuleNames.Add("OnlineSubsystem");
@@ -2,8 +2,11 @@
 
 #include "Actors/HopperBaseCharacter.h"
 
+#include "AISystem.h"
+#include "HexGridSubsystem.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "Perception/AISenseConfig.h"
+#include "Perception/AISense_Sight.h"
 
 AHopperBaseCharacter::AHopperBaseCharacter()
 {
@@ -12,6 +15,7 @@ AHopperBaseCharacter::AHopperBaseCharacter()
 	bAbilitiesInitialized = false;
 	bFootstepGate = true;
 	bAttackGate = true;
+	bHasLandedTile = false;
 
 	OnCharacterMovementUpdated.AddDynamic(this, &AHopperBaseCharacter::Animate);
 
@@ -46,6 +50,22 @@ void AHopperBaseCharacter::BeginPlay()
 	OnFootstepTakenNative.AddUObject(this, &AHopperBaseCharacter::OnFootstepNative);
 	OnAttackTimerEndNative.AddUObject(this, &AHopperBaseCharacter::OnAttackEndNative);
 	OnCharacterDeathNative.AddUObject(this, &AHopperBaseCharacter::OnDeathNative);
+
+	if (bUseHexGridOccupancy)
+	{
+		OnCharacterMovementUpdated.AddDynamic(this, &AHopperBaseCharacter::UpdateOccupiedTile);
+		UpdateOccupiedTile(0.f, GetActorLocation(), FVector::ZeroVector);
+	}
+}
+
+void AHopperBaseCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UHexGridSubsystem* HexGrid = GetWorld() ? GetWorld()->GetSubsystem<UHexGridSubsystem>() : nullptr)
+	{
+		HexGrid->RemoveOccupant(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AHopperBaseCharacter::OnJumped_Implementation()
@@ -68,6 +88,21 @@ void AHopperBaseCharacter::Landed(const FHitResult& Hit)
 	ModifyJumpPower();
 	GetWorldTimerManager().SetTimer(JumpReset, this, &AHopperBaseCharacter::ResetJumpPower, 0.2f, false);
 
+	// The floor is usually a grid HISM instance, which maps straight to its tile. Merged chunk collision takes the location lookup
+	bHasLandedTile = false;
+	if (const UHexGridSubsystem* HexGrid = GetWorld()->GetSubsystem<UHexGridSubsystem>())
+	{
+		FHexTileRef Tile = HexGrid->FindTileFromHit(Hit);
+		if (!Tile.IsValid())
+			Tile = HexGrid->FindTileAtLocation(Hit.ImpactPoint);
+
+		if (Tile.IsValid())
+		{
+			LandedTile = Tile.GetCoord();
+			bHasLandedTile = true;
+		}
+	}
+
 	Super::Landed(Hit);
 }
 
@@ -275,6 +310,89 @@ float AHopperBaseCharacter::GetMaxHealth() const
 	return Attributes->GetMaxHealth();
 }
 
+bool AHopperBaseCharacter::GetCurrentTile(FIntPoint& OutTile) const
+{
+	const UHexGridSubsystem* HexGrid = GetWorld() ? GetWorld()->GetSubsystem<UHexGridSubsystem>() : nullptr;
+	if (!HexGrid) return false;
+
+	const FHexTileRef Tile = HexGrid->FindTileAtLocation(GetActorLocation());
+	if (!Tile.IsValid()) return false;
+
+	OutTile = Tile.GetCoord();
+	return true;
+}
+
+void AHopperBaseCharacter::UpdateOccupiedTile(float DeltaTime, FVector OldLocation, const FVector OldVelocity)
+{
+	const FVector Location = GetActorLocation();
+	if (FVector2D::DistSquared(FVector2D(Location), OccupiedTileCentre) < OccupiedTileInnerRadiusSquared)
+		return;
+
+	UHexGridSubsystem* HexGrid = GetWorld() ? GetWorld()->GetSubsystem<UHexGridSubsystem>() : nullptr;
+	if (!HexGrid) return;
+
+	const FHexTileRef Tile = HexGrid->UpdateOccupant(this, Location);
+	if (!Tile.IsValid())
+	{
+		OccupiedTileInnerRadiusSquared = -1.0;
+		return;
+	}
+
+	// Hex rounding is only redone once the character leaves the circle that fits inside its hex
+	const FHexSpacing& Spacing = Tile.Store->GetSpacing();
+	OccupiedTileCentre = FVector2D(Tile.Store->GetTileLocation(Tile.TileIndex));
+	OccupiedTileInnerRadiusSquared = FMath::Square(0.5 * FMath::Min(Spacing.Column, Spacing.Row));
+}
+
+bool AHopperBaseCharacter::GetLandedTile(FIntPoint& OutTile) const
+{
+	if (!bHasLandedTile) return false;
+
+	OutTile = LandedTile;
+	return true;
+}
+
+UAISense_Sight::EVisibilityResult AHopperBaseCharacter::CanBeSeenFrom(const FCanBeSeenFromContext& Context,
+                                                                      FVector& OutSeenLocation,
+                                                                      int32& OutNumberOfLoSChecksPerformed,
+                                                                      int32& OutNumberOfAsyncLosCheckRequested,
+                                                                      float& OutSightStrength, int32* UserData,
+                                                                      const FOnPendingVisibilityQueryProcessedDelegate* Delegate)
+{
+	const FVector TargetLocation = GetActorLocation();
+	OutSeenLocation = TargetLocation;
+	OutSightStrength = 1.f;
+	OutNumberOfAsyncLosCheckRequested = 0;
+	OutNumberOfLoSChecksPerformed = 1;
+
+	UWorld* World = GetWorld();
+	if (!World) return UAISense_Sight::EVisibilityResult::NotVisible;
+
+	// Opted in characters are only hidden by tiles on the grid, so the tile walk replaces the trace there
+	UHexGridSubsystem* HexGrid = World->GetSubsystem<UHexGridSubsystem>();
+	if (bUseHexGridLineOfSight && HexGrid && HexGrid->FindTileAtLocation(Context.ObserverLocation).IsValid()
+		&& HexGrid->FindTileAtLocation(TargetLocation).IsValid())
+	{
+		// The tile pair cache puts both ends on their tile tops, which only holds while neither is in the air
+		const ACharacter* Observer = Cast<ACharacter>(Context.IgnoreActor);
+		const bool bBothGrounded = GetCharacterMovement()->IsMovingOnGround()
+			&& Observer && Observer->GetCharacterMovement() && Observer->GetCharacterMovement()->IsMovingOnGround();
+
+		const bool bVisible = bBothGrounded
+			                      ? HexGrid->HasTileLineOfSight(Context.ObserverLocation, TargetLocation, GetSimpleCollisionHalfHeight())
+			                      : HexGrid->HasLineOfSight(Context.ObserverLocation, TargetLocation);
+		return bVisible ? UAISense_Sight::EVisibilityResult::Visible : UAISense_Sight::EVisibilityResult::NotVisible;
+	}
+
+	FCollisionQueryParams Params(SCENE_QUERY_STAT(HopperSightLineOfSight), true, Context.IgnoreActor);
+	FHitResult Hit;
+	const bool bBlocked = World->LineTraceSingleByChannel(Hit, Context.ObserverLocation, TargetLocation,
+	                                                      GET_AI_CONFIG_VAR(DefaultSightCollisionChannel), Params);
+	return !bBlocked || Hit.GetActor() == this
+		       ? UAISense_Sight::EVisibilityResult::Visible
+		       : UAISense_Sight::EVisibilityResult::NotVisible;
+}
+
 void AHopperBaseCharacter::Animate(float DeltaTime, FVector OldLocation, const FVector OldVelocity)
 {
 	if (!bAttackGate) return;
@@ -0,0 +1,24 @@
+#include "HexBiomeTable.h"
+
+void FHexBiome::GetCustomData(float Highlight, float Fog, TArrayView<float> OutCustomData) const
+{
+	check(OutCustomData.Num() >= HexBiomeCustomData::Num);
+
+	OutCustomData[HexBiomeCustomData::ColourR] = Colour.R;
+	OutCustomData[HexBiomeCustomData::ColourG] = Colour.G;
+	OutCustomData[HexBiomeCustomData::ColourB] = Colour.B;
+	OutCustomData[HexBiomeCustomData::Wetness] = Wetness;
+	OutCustomData[HexBiomeCustomData::Highlight] = Highlight;
+	OutCustomData[HexBiomeCustomData::Fog] = Fog;
+}
+
+uint8 UHexBiomeTable::Classify(TConstArrayView<FHexBiomeThresholds> Thresholds, float Height, float Moisture)
+{
+	for (int32 i = 0; i < Thresholds.Num(); ++i)
+	{
+		if (Thresholds[i].Contains(Height, Moisture))
+			return static_cast<uint8>(i);
+	}
+
+	return static_cast<uint8>(FMath::Max(Thresholds.Num() - 1, 0));
+}
@@ -0,0 +1,121 @@
+#include "HexChunkCollisionComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Engine/CollisionProfile.h"
+#include "AI/NavigationSystemBase.h"
+
+UHexChunkCollisionComponent::UHexChunkCollisionComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	Mobility = EComponentMobility::Movable;
+
+	SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	SetGenerateOverlapEvents(false);
+}
+
+void UHexChunkCollisionComponent::Build(const FHexChunkTiles& Tiles, TConstArrayView<FHexTileExtent> Extents, EHexCollisionMode Mode)
+{
+	Surface.Reset();
+	LocalBounds.Init();
+
+	if (!BodySetup)
+	{
+		BodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+		BodySetup->bGenerateMirroredCollision = false;
+		BodySetup->bDoubleSidedGeometry = true;
+	}
+
+	BodySetup->InvalidatePhysicsData();
+	BodySetup->AggGeom.EmptyElements();
+	BodySetup->BodySetupGuid = FGuid::NewGuid();
+	BodySetup->CollisionTraceFlag = Mode == EHexCollisionMode::ChunkTriMesh ? CTF_UseComplexAsSimple : CTF_UseSimpleAsComplex;
+
+	if (Mode == EHexCollisionMode::ChunkTriMesh)
+	{
+		Surface.Build(Tiles, Extents);
+		if (Surface.Bounds.IsValid)
+		{
+			LocalBounds = FBox(Surface.Bounds);
+		}
+	}
+	else if (Mode == EHexCollisionMode::ChunkConvex)
+	{
+		FVector2f Corners[FHexChunkSurface::NumCorners];
+		FHexChunkSurface::GetCorners(Tiles.Spacing, Corners);
+
+		for (int32 Local = 0; Local < Tiles.Centres.Num(); ++Local)
+		{
+			if (!Tiles.Valid[Local]) continue;
+
+			const FVector3f& Centre = Tiles.Centres[Local];
+			const FHexTileExtent& Extent = Extents[Tiles.MeshSlots[Local]];
+
+			FKConvexElem& Elem = BodySetup->AggGeom.ConvexElems.AddDefaulted_GetRef();
+			Elem.VertexData.Reserve(FHexChunkSurface::NumCorners * 2);
+			for (const FVector2f& Corner : Corners)
+			{
+				Elem.VertexData.Add(FVector(Centre.X + Corner.X, Centre.Y + Corner.Y, Extent.GetTop(Centre.Z)));
+				Elem.VertexData.Add(FVector(Centre.X + Corner.X, Centre.Y + Corner.Y, Extent.GetBottom(Centre.Z)));
+			}
+			Elem.UpdateElemBox();
+			LocalBounds += Elem.ElemBox;
+		}
+	}
+
+	if (LocalBounds.IsValid)
+	{
+		BodySetup->CreatePhysicsMeshes();
+	}
+
+	UpdateBounds();
+	RecreatePhysicsState();
+	FNavigationSystem::UpdateComponentData(*this);
+}
+
+void UHexChunkCollisionComponent::ClearCollision()
+{
+	Surface = FHexChunkSurface();
+	LocalBounds.Init();
+
+	if (BodySetup)
+	{
+		BodySetup->InvalidatePhysicsData();
+		BodySetup->AggGeom.EmptyElements();
+	}
+
+	UpdateBounds();
+	RecreatePhysicsState();
+	FNavigationSystem::UpdateComponentData(*this);
+}
+
+int32 UHexChunkCollisionComponent::GetNumShapes() const
+{
+	if (!BodySetup) return 0;
+
+	return Surface.Indices.Num() > 0 ? 1 : BodySetup->AggGeom.ConvexElems.Num();
+}
+
+FBoxSphereBounds UHexChunkCollisionComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!LocalBounds.IsValid)
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+
+	return FBoxSphereBounds(LocalBounds).TransformBy(LocalToWorld);
+}
+
+bool UHexChunkCollisionComponent::GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData)
+{
+	CollisionData->Vertices = Surface.Positions;
+
+	CollisionData->Indices.SetNumUninitialized(Surface.GetNumTriangles());
+	for (int32 Triangle = 0; Triangle < Surface.GetNumTriangles(); ++Triangle)
+	{
+		CollisionData->Indices[Triangle].v0 = Surface.Indices[Triangle * 3];
+		CollisionData->Indices[Triangle].v1 = Surface.Indices[Triangle * 3 + 1];
+		CollisionData->Indices[Triangle].v2 = Surface.Indices[Triangle * 3 + 2];
+	}
+
+	// Rebuilt on every tile edit, the cheap cook is worth more than a tighter mesh
+	CollisionData->bDeformableMesh = true;
+	CollisionData->bFastCook = true;
+	return Surface.Indices.Num() > 0;
+}
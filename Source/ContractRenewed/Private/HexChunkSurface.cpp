@@ -0,0 +1,201 @@
+#include "HexChunkSurface.h"
+#include "HexTileStore.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+
+const FName FHexChunkSurface::ProxyMaterialSlot(TEXT("HexProxy"));
+
+namespace HexChunkSurface
+{
+	// Edge of the hex each neighbour direction crosses
+	void GetDirectionEdges(const FHexSpacing& Spacing, int32 OutEdges[HexLayout::NumDirections])
+	{
+		const FVector2f Centre = FHexGridLayout::OffsetToWorld(FIntPoint::ZeroValue, Spacing);
+		for (int32 Direction = 0; Direction < HexLayout::NumDirections; ++Direction)
+		{
+			const FVector2f Delta = FHexGridLayout::OffsetToWorld(FHexGridLayout::OffsetNeighbour(FIntPoint::ZeroValue, Direction), Spacing) - Centre;
+			const int32 Edge = FMath::RoundToInt32(FMath::RadiansToDegrees(FMath::Atan2(Delta.Y, Delta.X)) / 60.f);
+			OutEdges[Direction] = (Edge % FHexChunkSurface::NumCorners + FHexChunkSurface::NumCorners) % FHexChunkSurface::NumCorners;
+		}
+	}
+}
+
+bool FHexChunkTiles::Read(const FHexTileStore& TileStore, const FIntPoint& InChunkCoord)
+{
+	const int32 ChunkBase = TileStore.FindChunkBase(InChunkCoord);
+	if (ChunkBase == INDEX_NONE)
+		return false;
+
+	ChunkCoord = InChunkCoord;
+	ChunkSize = TileStore.GetChunkSize();
+	Spacing = TileStore.GetSpacing();
+	OriginTile = TileStore.GetChunkOriginTile(ChunkCoord);
+
+	const int32 NumTiles = TileStore.GetTilesPerChunk();
+	Centres.SetNumUninitialized(NumTiles);
+	Biomes.SetNumZeroed(NumTiles);
+	MeshSlots.SetNumZeroed(NumTiles);
+	Valid.Init(false, NumTiles);
+
+	for (int32 Local = 0; Local < NumTiles; ++Local)
+	{
+		const int32 TileIndex = ChunkBase + Local;
+		if (!TileStore.IsValidTile(TileIndex))
+		{
+			Centres[Local] = FVector3f::ZeroVector;
+			continue;
+		}
+
+		const FVector2f TilePos = FHexGridLayout::OffsetToWorld(TileStore.GetTileCoord(TileIndex) - OriginTile, Spacing);
+		Centres[Local] = FVector3f(TilePos.X, TilePos.Y, TileStore.GetHeight(TileIndex));
+		Biomes[Local] = TileStore.GetBiome(TileIndex);
+		MeshSlots[Local] = TileStore.GetMeshSlot(TileIndex);
+		Valid[Local] = true;
+	}
+	return true;
+}
+
+void FHexChunkSurface::Reset()
+{
+	Positions.Reset();
+	VertexBiomes.Reset();
+	Indices.Reset();
+	Bounds.Init();
+}
+
+void FHexChunkSurface::GetCorners(const FHexSpacing& Spacing, FVector2f OutCorners[NumCorners])
+{
+	const float RadiusX = Spacing.Column / UE_SQRT_3;
+	const float RadiusY = Spacing.Row / 1.5f;
+	for (int32 Corner = 0; Corner < NumCorners; ++Corner)
+	{
+		const float Angle = FMath::DegreesToRadians(60.f * Corner - 30.f);
+		OutCorners[Corner] = FVector2f(RadiusX * FMath::Cos(Angle), RadiusY * FMath::Sin(Angle));
+	}
+}
+
+void FHexChunkSurface::AddTriangle(int32 A, int32 B, int32 C, const FVector3f& Facing)
+{
+	// Front faces are the ones whose (B - A) ^ (C - A) points at the viewer
+	const FVector3f Normal = (Positions[B] - Positions[A]) ^ (Positions[C] - Positions[A]);
+	if ((Normal | Facing) < 0.f)
+	{
+		Swap(B, C);
+	}
+
+	Indices.Add(A);
+	Indices.Add(B);
+	Indices.Add(C);
+}
+
+void FHexChunkSurface::Build(const FHexChunkTiles& Tiles, TConstArrayView<FHexTileExtent> Extents)
+{
+	Reset();
+
+	FVector2f Corners[NumCorners];
+	int32 DirectionEdges[HexLayout::NumDirections];
+	GetCorners(Tiles.Spacing, Corners);
+	HexChunkSurface::GetDirectionEdges(Tiles.Spacing, DirectionEdges);
+
+	const FIntPoint ChunkOrigin = Tiles.ChunkCoord * Tiles.ChunkSize;
+	for (int32 Local = 0; Local < Tiles.Centres.Num(); ++Local)
+	{
+		if (!Tiles.Valid[Local]) continue;
+
+		const FVector3f& Centre = Tiles.Centres[Local];
+		const uint8 Biome = Tiles.Biomes[Local];
+		const FHexTileExtent& Extent = Extents[Tiles.MeshSlots[Local]];
+		const float Top = Extent.GetTop(Centre.Z);
+		const float Bottom = Extent.GetBottom(Centre.Z);
+
+		// Hex top as a fan over its corners
+		const int32 TopBase = Positions.Num();
+		for (const FVector2f& Corner : Corners)
+		{
+			Positions.Add(FVector3f(Centre.X + Corner.X, Centre.Y + Corner.Y, Top));
+			VertexBiomes.Add(Biome);
+			Bounds += Positions.Last();
+		}
+
+		for (int32 Corner = 1; Corner < NumCorners - 1; ++Corner)
+		{
+			AddTriangle(TopBase, TopBase + Corner, TopBase + Corner + 1, FVector3f::UpVector);
+		}
+
+		// Walls only where the ground steps down, a higher neighbour in the chunk already covers the step up
+		const FIntPoint TileCoord = ChunkOrigin + FIntPoint(Local % Tiles.ChunkSize, Local / Tiles.ChunkSize);
+		for (int32 Direction = 0; Direction < HexLayout::NumDirections; ++Direction)
+		{
+			float WallBottom = Bottom;
+
+			const FIntPoint NeighbourLocal = FHexGridLayout::OffsetNeighbour(TileCoord, Direction) - ChunkOrigin;
+			if (NeighbourLocal.X >= 0 && NeighbourLocal.Y >= 0 && NeighbourLocal.X < Tiles.ChunkSize && NeighbourLocal.Y < Tiles.ChunkSize)
+			{
+				const int32 NeighbourIndex = NeighbourLocal.Y * Tiles.ChunkSize + NeighbourLocal.X;
+				if (Tiles.Valid[NeighbourIndex])
+				{
+					const float NeighbourTop = Extents[Tiles.MeshSlots[NeighbourIndex]].GetTop(Tiles.Centres[NeighbourIndex].Z);
+					if (NeighbourTop >= Top) continue;
+
+					WallBottom = FMath::Max(NeighbourTop, Bottom);
+				}
+			}
+
+			const int32 Edge = DirectionEdges[Direction];
+			const int32 NextEdge = (Edge + 1) % NumCorners;
+			const int32 WallBase = Positions.Num();
+			Positions.Add(FVector3f(Centre.X + Corners[Edge].X, Centre.Y + Corners[Edge].Y, WallBottom));
+			Positions.Add(FVector3f(Centre.X + Corners[NextEdge].X, Centre.Y + Corners[NextEdge].Y, WallBottom));
+			VertexBiomes.Add(Biome);
+			VertexBiomes.Add(Biome);
+			Bounds += Positions[WallBase];
+
+			const FVector2f Outwards = Corners[Edge] + Corners[NextEdge];
+			AddTriangle(TopBase + Edge, WallBase, WallBase + 1, FVector3f(Outwards.X, Outwards.Y, 0.f));
+			AddTriangle(TopBase + Edge, WallBase + 1, TopBase + NextEdge, FVector3f(Outwards.X, Outwards.Y, 0.f));
+		}
+	}
+}
+
+void FHexChunkSurface::ToMeshDescription(TConstArrayView<FLinearColor> BiomeColours, FMeshDescription& OutMeshDescription) const
+{
+	FStaticMeshAttributes Attributes(OutMeshDescription);
+	Attributes.Register();
+
+	TVertexAttributesRef<FVector3f> VertexPositions = Attributes.GetVertexPositions();
+	TVertexInstanceAttributesRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+	TVertexInstanceAttributesRef<FVector4f> Colours = Attributes.GetVertexInstanceColors();
+	TVertexInstanceAttributesRef<FVector2f> UVs = Attributes.GetVertexInstanceUVs();
+
+	OutMeshDescription.ReserveNewVertices(Positions.Num());
+	OutMeshDescription.ReserveNewVertexInstances(Indices.Num());
+	OutMeshDescription.ReserveNewTriangles(GetNumTriangles());
+
+	const FPolygonGroupID PolygonGroup = OutMeshDescription.CreatePolygonGroup();
+	Attributes.GetPolygonGroupMaterialSlotNames()[PolygonGroup] = ProxyMaterialSlot;
+
+	for (const FVector3f& Position : Positions)
+	{
+		VertexPositions[OutMeshDescription.CreateVertex()] = Position;
+	}
+
+	// Vertex instances aren't shared so every triangle keeps its own flat normal, tops stay crisp from a distance
+	for (int32 i = 0; i < Indices.Num(); i += 3)
+	{
+		const FVector3f Normal = ((Positions[Indices[i + 1]] - Positions[Indices[i]]) ^ (Positions[Indices[i + 2]] - Positions[Indices[i]])).GetSafeNormal();
+
+		FVertexInstanceID Corners[3];
+		for (int32 Corner = 0; Corner < 3; ++Corner)
+		{
+			const int32 Vertex = Indices[i + Corner];
+			const FLinearColor Colour = BiomeColours.IsValidIndex(VertexBiomes[Vertex]) ? BiomeColours[VertexBiomes[Vertex]] : FLinearColor::White;
+
+			Corners[Corner] = OutMeshDescription.CreateVertexInstance(FVertexID(Vertex));
+			Normals[Corners[Corner]] = Normal;
+			Colours[Corners[Corner]] = FVector4f(Colour.R, Colour.G, Colour.B, Colour.A);
+			UVs[Corners[Corner]] = FVector2f(Positions[Vertex].X, Positions[Vertex].Y) * 0.01f;
+		}
+
+		OutMeshDescription.CreateTriangle(PolygonGroup, Corners);
+	}
+}
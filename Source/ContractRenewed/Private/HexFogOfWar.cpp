@@ -0,0 +1,261 @@
+#include "HexFogOfWar.h"
+#include "HexIterators.h"
+#include "HexTileStore.h"
+
+int32 FHexFogOfWar::AddViewer(int32 PlayerId, int32 SightRadius, float EyeHeight)
+{
+	FViewer Viewer;
+	Viewer.PlayerId = PlayerId;
+	Viewer.SightRadius = FMath::Max(SightRadius, 0);
+	Viewer.EyeHeight = EyeHeight;
+
+	Players.FindOrAdd(PlayerId);
+	return Viewers.Add(MoveTemp(Viewer));
+}
+
+void FHexFogOfWar::RemoveViewer(int32 ViewerId)
+{
+	if (!Viewers.IsValidIndex(ViewerId)) return;
+
+	FViewer& Viewer = Viewers[ViewerId];
+	if (FPlayer* Player = Players.Find(Viewer.PlayerId))
+	{
+		for (const FIntPoint& TileCoord : Viewer.VisibleTiles)
+		{
+			RemoveVisibleTile(*Player, TileCoord);
+		}
+	}
+
+	Viewers.RemoveAt(ViewerId);
+}
+
+bool FHexFogOfWar::UpdateViewer(int32 ViewerId, const FHexTileStore& TileStore, const FVector& WorldLocation)
+{
+	if (!Viewers.IsValidIndex(ViewerId)) return false;
+
+	FViewer& Viewer = Viewers[ViewerId];
+	const FIntPoint Tile = TileStore.WorldToTileCoord(WorldLocation);
+	if (Viewer.bHasTile && Viewer.Tile == Tile && IsViewCurrent(TileStore, Viewer)) return false;
+
+	Viewer.bHasTile = true;
+	Viewer.Tile = Tile;
+	Viewer.Revision = TileStore.GetRevision();
+	ComputeFieldOfView(TileStore, Tile, Viewer.SightRadius, Viewer.EyeHeight, NewVisibleTiles, Horizons);
+
+	// Adding before removing keeps tiles in both views from flipping to explored and back
+	FPlayer& Player = Players.FindOrAdd(Viewer.PlayerId);
+	for (const FIntPoint& TileCoord : NewVisibleTiles)
+	{
+		AddVisibleTile(Player, TileCoord);
+	}
+	for (const FIntPoint& TileCoord : Viewer.VisibleTiles)
+	{
+		RemoveVisibleTile(Player, TileCoord);
+	}
+
+	Swap(Viewer.VisibleTiles, NewVisibleTiles);
+	return true;
+}
+
+void FHexFogOfWar::Reset()
+{
+	Viewers.Empty();
+	Players.Empty();
+}
+
+EHexFogState FHexFogOfWar::GetTileState(int32 PlayerId, const FIntPoint& TileCoord) const
+{
+	const FPlayer* Player = Players.Find(PlayerId);
+	const FPage* Page = Player ? Player->Pages.Find(GetPageCoord(TileCoord)) : nullptr;
+	if (!Page) return EHexFogState::Unexplored;
+
+	const int32 Index = GetPageIndex(TileCoord);
+	if (GetBit(Page->Visible, Index)) return EHexFogState::Visible;
+	return GetBit(Page->Explored, Index) ? EHexFogState::Explored : EHexFogState::Unexplored;
+}
+
+bool FHexFogOfWar::IsTileVisibleToAny(const FIntPoint& TileCoord) const
+{
+	const FIntPoint PageCoord = GetPageCoord(TileCoord);
+	const int32 Index = GetPageIndex(TileCoord);
+
+	for (const TPair<int32, FPlayer>& Pair : Players)
+	{
+		const FPage* Page = Pair.Value.Pages.Find(PageCoord);
+		if (Page && GetBit(Page->Visible, Index)) return true;
+	}
+	return false;
+}
+
+void FHexFogOfWar::GetPlayerIds(TArray<int32>& OutPlayerIds) const
+{
+	Players.GenerateKeyArray(OutPlayerIds);
+}
+
+void FHexFogOfWar::ConsumeChangedTiles(int32 PlayerId, TArray<FIntPoint>& OutTiles)
+{
+	FPlayer* Player = Players.Find(PlayerId);
+	if (!Player) return;
+
+	for (const FIntPoint& TileCoord : Player->ChangedTiles)
+	{
+		SetBit(Player->Pages.FindChecked(GetPageCoord(TileCoord)).Changed, GetPageIndex(TileCoord), false);
+	}
+
+	OutTiles.Append(Player->ChangedTiles);
+	Player->ChangedTiles.Reset();
+}
+
+SIZE_T FHexFogOfWar::GetAllocatedSize() const
+{
+	SIZE_T Size = Viewers.GetAllocatedSize() + Players.GetAllocatedSize() + NewVisibleTiles.GetAllocatedSize() + Horizons.GetAllocatedSize();
+
+	for (const FViewer& Viewer : Viewers)
+	{
+		Size += Viewer.VisibleTiles.GetAllocatedSize();
+	}
+
+	for (const TPair<int32, FPlayer>& Pair : Players)
+	{
+		Size += Pair.Value.Pages.GetAllocatedSize() + Pair.Value.ChangedTiles.GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+void FHexFogOfWar::ComputeFieldOfView(const FHexTileStore& TileStore, const FIntPoint& CentreTile, int32 SightRadius, float EyeHeight,
+	TArray<FIntPoint>& OutTiles, TArray<float>& Horizons)
+{
+	OutTiles.Reset();
+
+	const int32 CentreIndex = TileStore.FindTile(CentreTile);
+	if (CentreIndex == INDEX_NONE || SightRadius < 0) return;
+
+	const FHexAxial CentreAxial = FHexGridLayout::OffsetToAxial(FHexOffset(CentreTile));
+	const FHexSpacing& Spacing = TileStore.GetSpacing();
+	const float EyeZ = TileStore.GetGroundHeight(CentreIndex) + EyeHeight;
+
+	// Steepest slope from the eye to a tile top between the centre and each hex of the range, indexed by axial offset
+	const int32 Side = SightRadius * 2 + 1;
+	Horizons.SetNumUninitialized(Side * Side, EAllowShrinking::No);
+	auto Horizon = [&Horizons, Side, SightRadius](const FHexAxial& Offset) -> float&
+	{
+		return Horizons[(Offset.Q + SightRadius) * Side + Offset.R + SightRadius];
+	};
+
+	bool bHasChunk = false;
+	FIntPoint LastChunkCoord = FIntPoint::ZeroValue;
+	int32 LastChunkBase = INDEX_NONE;
+
+	for (FHexSpiralIterator It(FHexAxial(0, 0), SightRadius); It; ++It)
+	{
+		const FHexAxial Offset = *It;
+		const int32 Ring = It.GetRadius();
+		if (Ring == 0)
+		{
+			Horizon(Offset) = -MAX_flt;
+			OutTiles.Add(CentreTile);
+			continue;
+		}
+
+		// The line back to the centre crosses the previous ring through one hex, or between two when it runs along an edge.
+		// Taking the lower horizon of the two lets tiles show that either side would reveal
+		const float Alpha = static_cast<float>(Ring - 1) / Ring;
+		const FHexAxial ParentA = HexLayout::Round(Offset.Q * Alpha + 1e-4f, Offset.R * Alpha + 2e-4f);
+		const FHexAxial ParentB = HexLayout::Round(Offset.Q * Alpha - 1e-4f, Offset.R * Alpha - 2e-4f);
+		const float ParentHorizon = FMath::Min(Horizon(ParentA), Horizon(ParentB));
+
+		float& TileHorizon = Horizon(Offset);
+		TileHorizon = ParentHorizon;
+
+		const FIntPoint TileCoord = FHexGridLayout::AxialToOffset(CentreAxial + Offset).ToIntPoint();
+		const FIntPoint ChunkCoord = TileStore.GetChunkCoord(TileCoord);
+		if (!bHasChunk || ChunkCoord != LastChunkCoord)
+		{
+			bHasChunk = true;
+			LastChunkCoord = ChunkCoord;
+			LastChunkBase = TileStore.FindChunkBase(ChunkCoord);
+		}
+
+		if (LastChunkBase == INDEX_NONE) continue;
+
+		const int32 TileIndex = LastChunkBase + TileStore.GetLocalIndex(TileCoord);
+		if (!TileStore.IsValidTile(TileIndex)) continue;
+
+		const float Slope = (TileStore.GetGroundHeight(TileIndex) - EyeZ) / FHexGridLayout::AxialToWorld(Offset, Spacing).Size();
+		if (Slope >= ParentHorizon)
+		{
+			OutTiles.Add(TileCoord);
+			TileHorizon = Slope;
+		}
+	}
+}
+
+void FHexFogOfWar::SetBit(uint64* Words, int32 Index, bool bValue)
+{
+	const uint64 Mask = uint64(1) << (Index & 63);
+	if (bValue)
+	{
+		Words[Index >> 6] |= Mask;
+	}
+	else
+	{
+		Words[Index >> 6] &= ~Mask;
+	}
+}
+
+bool FHexFogOfWar::IsViewCurrent(const FHexTileStore& TileStore, FViewer& Viewer)
+{
+	if (Viewer.Revision == TileStore.GetRevision()) return true;
+
+	// Offset coordinates reach at most one column further than the axial radius
+	const int32 Reach = Viewer.SightRadius + 1;
+	const FIntPoint MinChunk = TileStore.GetChunkCoord(Viewer.Tile - FIntPoint(Reach, Reach));
+	const FIntPoint MaxChunk = TileStore.GetChunkCoord(Viewer.Tile + FIntPoint(Reach, Reach));
+	for (int32 ChunkY = MinChunk.Y; ChunkY <= MaxChunk.Y; ++ChunkY)
+	{
+		for (int32 ChunkX = MinChunk.X; ChunkX <= MaxChunk.X; ++ChunkX)
+		{
+			if (TileStore.GetChunkRevision(FIntPoint(ChunkX, ChunkY)) > Viewer.Revision)
+				return false;
+		}
+	}
+
+	Viewer.Revision = TileStore.GetRevision();
+	return true;
+}
+
+void FHexFogOfWar::AddVisibleTile(FPlayer& Player, const FIntPoint& TileCoord)
+{
+	FPage& Page = Player.Pages.FindOrAdd(GetPageCoord(TileCoord));
+	const int32 Index = GetPageIndex(TileCoord);
+
+	uint8& Count = Page.ViewerCounts[Index];
+	check(Count < MAX_uint8);
+	if (Count++ > 0) return;
+
+	SetBit(Page.Visible, Index, true);
+	SetBit(Page.Explored, Index, true);
+	MarkChanged(Player, Page, TileCoord, Index);
+}
+
+void FHexFogOfWar::RemoveVisibleTile(FPlayer& Player, const FIntPoint& TileCoord)
+{
+	FPage* Page = Player.Pages.Find(GetPageCoord(TileCoord));
+	if (!Page) return;
+
+	const int32 Index = GetPageIndex(TileCoord);
+	uint8& Count = Page->ViewerCounts[Index];
+	if (Count == 0 || --Count > 0) return;
+
+	SetBit(Page->Visible, Index, false);
+	MarkChanged(Player, *Page, TileCoord, Index);
+}
+
+void FHexFogOfWar::MarkChanged(FPlayer& Player, FPage& Page, const FIntPoint& TileCoord, int32 Index)
+{
+	if (GetBit(Page.Changed, Index)) return;
+
+	SetBit(Page.Changed, Index, true);
+	Player.ChangedTiles.Add(TileCoord);
+}
@@ -0,0 +1,75 @@
+#include "HexGridBakeCommandlet.h"
+#include "HexManager.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+UHexGridBakeCommandlet::UHexGridBakeCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UHexGridBakeCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapsParam;
+	if (!FParse::Value(*Params, TEXT("Maps="), MapsParam))
+	{
+		MapsParam = TEXT("/Game/Maps/Easy+/Game/Maps/Hard+/Game/Maps/Level1");
+	}
+
+	TArray<FString> MapNames;
+	MapsParam.ParseIntoArray(MapNames, TEXT("+"));
+
+	int32 NumFailed = 0;
+	for (const FString& MapName : MapNames)
+	{
+		UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+		UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+		if (!World)
+		{
+			UE_LOG(LogTemp, Error, TEXT("HexGridBake: could not load %s"), *MapName);
+			++NumFailed;
+			continue;
+		}
+
+		int32 NumBaked = 0;
+		for (TActorIterator<AHexManager> It(World); It; ++It)
+		{
+			if (It->BakeGrid())
+			{
+				++NumBaked;
+			}
+		}
+
+		if (NumBaked == 0)
+		{
+			UE_LOG(LogTemp, Display, TEXT("HexGridBake: nothing to bake in %s"), *MapName);
+			continue;
+		}
+
+		Package->MarkPackageDirty();
+
+		const FString Filename = FPackageName::LongPackageNameToFilename(MapName, FPackageName::GetMapPackageExtension());
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Standalone;
+		if (!UPackage::SavePackage(Package, World, *Filename, SaveArgs))
+		{
+			UE_LOG(LogTemp, Error, TEXT("HexGridBake: failed to save %s"), *Filename);
+			++NumFailed;
+			continue;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("HexGridBake: baked %d grid(s) into %s"), NumBaked, *MapName);
+	}
+
+	return NumFailed == 0 ? 0 : 1;
+#else
+	return 1;
+#endif
+}
@@ -0,0 +1,254 @@
+#include "HexGridCache.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Hash/xxhash.h"
+#include "Misc/Paths.h"
+
+FHexGridCache::FHexGridCache() = default;
+FHexGridCache::~FHexGridCache()
+{
+	// The region has to go before the handle it was mapped from
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+}
+
+uint64 FHexGridCache::MakeKey(const FHexNoiseSettings& NoiseSettings, const FHexGenerationInputs& Inputs)
+{
+	FXxHash64Builder Builder;
+	auto Add = [&Builder](const auto& Value) { Builder.Update(&Value, sizeof(Value)); };
+
+	Add(Version);
+
+	auto AddNoise = [&Add](const FHexNoiseSettings& Noise)
+	{
+		Add(Noise.NoiseType);
+		Add(Noise.Seed);
+		Add(Noise.Frequency);
+		Add(Noise.Interp);
+		Add(Noise.FractalType);
+		Add(Noise.Octaves);
+		Add(Noise.Lacunarity);
+		Add(Noise.Gain);
+		Add(Noise.CellularJitter);
+		Add(Noise.CellularDistanceFunction);
+		Add(Noise.CellularReturnType);
+	};
+
+	AddNoise(NoiseSettings);
+
+	Add(Inputs.Spacing.Column);
+	Add(Inputs.Spacing.Row);
+	Add(Inputs.HeightStrength);
+	Add(Inputs.GridWidth);
+	Add(Inputs.GridHeight);
+	Add(Inputs.ChunkSize);
+	Add(Inputs.bUnbounded);
+
+	Add(Inputs.bSampleMoisture);
+	if (Inputs.bSampleMoisture)
+	{
+		AddNoise(Inputs.MoistureSettings);
+	}
+
+	for (const FHexBiomeThresholds& Thresholds : Inputs.BiomeThresholds)
+	{
+		Add(Thresholds.MinHeight);
+		Add(Thresholds.MaxHeight);
+		Add(Thresholds.MinMoisture);
+		Add(Thresholds.MaxMoisture);
+	}
+
+	return Builder.Finalize().Hash;
+}
+
+FString FHexGridCache::GetCachePath(uint64 Key)
+{
+	return FPaths::ProjectSavedDir() / TEXT("HexGridCache") / FString::Printf(TEXT("%016llx.hexgrid"), Key);
+}
+
+int64 FHexGridCache::GetFileSize(int32 NumChunks, int32 NumTiles)
+{
+	return sizeof(FFileHeader)
+		+ static_cast<int64>(NumChunks) * sizeof(FFileChunk)
+		+ static_cast<int64>(NumTiles) * (sizeof(FIntPoint) + sizeof(FVector3f) + sizeof(float) + sizeof(uint8));
+}
+
+bool FHexGridCache::Open(const FString& Path, uint64 Key)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Path)) return false;
+
+	// Eviction goes by timestamp, a hit counts as a use
+	PlatformFile.SetTimeStamp(*Path, FDateTime::UtcNow());
+
+	FOpenMappedResult OpenResult = PlatformFile.OpenMappedEx(*Path);
+	if (OpenResult.HasError()) return false;
+
+	MappedHandle = OpenResult.StealValue();
+	if (MappedHandle->GetFileSize() < static_cast<int64>(sizeof(FFileHeader))) return false;
+
+	MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	if (!MappedRegion) return false;
+
+	const uint8* Data = MappedRegion->GetMappedPtr();
+	Header = reinterpret_cast<const FFileHeader*>(Data);
+
+	if (Header->Magic != Magic || Header->Version != Version || Header->Key != Key
+		|| Header->NumChunks < 0 || Header->NumTiles < 0
+		|| MappedRegion->GetMappedSize() < GetFileSize(Header->NumChunks, Header->NumTiles))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ignoring stale hex grid cache %s"), *Path);
+		Header = nullptr;
+		return false;
+	}
+
+	const FFileChunk* ChunkTable = reinterpret_cast<const FFileChunk*>(Data + sizeof(FFileHeader));
+	const uint8* TileData = reinterpret_cast<const uint8*>(ChunkTable + Header->NumChunks);
+
+	TileCoords = reinterpret_cast<const FIntPoint*>(TileData);
+	LocalPositions = reinterpret_cast<const FVector3f*>(TileCoords + Header->NumTiles);
+	Heights = reinterpret_cast<const float*>(LocalPositions + Header->NumTiles);
+	Biomes = reinterpret_cast<const uint8*>(Heights + Header->NumTiles);
+
+	Chunks.Reserve(Header->NumChunks);
+	for (int32 i = 0; i < Header->NumChunks; ++i)
+	{
+		const FFileChunk& Chunk = ChunkTable[i];
+		if (Chunk.FirstTile < 0 || Chunk.NumTiles < 0 || Chunk.FirstTile + Chunk.NumTiles > Header->NumTiles)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Ignoring corrupt hex grid cache %s"), *Path);
+			Chunks.Empty();
+			Header = nullptr;
+			return false;
+		}
+		Chunks.Add(Chunk.ChunkCoord, Chunk);
+	}
+
+	return true;
+}
+
+bool FHexGridCache::ReadChunk(const FIntPoint& ChunkCoord, FHexChunkBuffer& OutChunk) const
+{
+	const FFileChunk* Chunk = Chunks.Find(ChunkCoord);
+	if (!Header || !Chunk) return false;
+
+	const int32 First = Chunk->FirstTile;
+	const int32 Num = Chunk->NumTiles;
+
+	OutChunk.ChunkCoord = ChunkCoord;
+	OutChunk.TileCoords = TArray<FIntPoint>(TileCoords + First, Num);
+	OutChunk.Heights = TArray<float>(Heights + First, Num);
+	OutChunk.Biomes = TArray<uint8>(Biomes + First, Num);
+
+	OutChunk.LocalPositions.SetNumUninitialized(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		OutChunk.LocalPositions[i] = FVector(LocalPositions[First + i]);
+	}
+
+	return true;
+}
+
+bool FHexGridCache::Write(const FString& Path, uint64 Key, int32 ChunkSize, const TArray<FHexChunkBuffer>& ChunkBuffers)
+{
+	FFileHeader FileHeader = {};
+	FileHeader.Magic = Magic;
+	FileHeader.Version = Version;
+	FileHeader.Key = Key;
+	FileHeader.ChunkSize = ChunkSize;
+	FileHeader.NumChunks = ChunkBuffers.Num();
+
+	TArray<FFileChunk> ChunkTable;
+	ChunkTable.Reserve(ChunkBuffers.Num());
+	for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
+	{
+		FFileChunk& Chunk = ChunkTable.AddDefaulted_GetRef();
+		Chunk.ChunkCoord = ChunkBuffer.ChunkCoord;
+		Chunk.FirstTile = FileHeader.NumTiles;
+		Chunk.NumTiles = ChunkBuffer.TileCoords.Num();
+		FileHeader.NumTiles += Chunk.NumTiles;
+	}
+
+	// Grids with the same inputs write the same cache at the same time, each writes its own temporary file
+	const FString TempPath = FPaths::CreateTempFilename(*FPaths::GetPath(Path), *FPaths::GetBaseFilename(Path), TEXT(".tmp"));
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+	if (!Writer) return false;
+
+	Writer->Serialize(&FileHeader, sizeof(FileHeader));
+	Writer->Serialize(ChunkTable.GetData(), ChunkTable.Num() * sizeof(FFileChunk));
+
+	for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
+	{
+		Writer->Serialize(const_cast<FIntPoint*>(ChunkBuffer.TileCoords.GetData()), ChunkBuffer.TileCoords.Num() * sizeof(FIntPoint));
+	}
+
+	for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
+	{
+		for (const FVector& LocalPos : ChunkBuffer.LocalPositions)
+		{
+			FVector3f Position(LocalPos);
+			Writer->Serialize(&Position, sizeof(Position));
+		}
+	}
+
+	for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
+	{
+		Writer->Serialize(const_cast<float*>(ChunkBuffer.Heights.GetData()), ChunkBuffer.Heights.Num() * sizeof(float));
+	}
+
+	for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
+	{
+		Writer->Serialize(const_cast<uint8*>(ChunkBuffer.Biomes.GetData()), ChunkBuffer.Biomes.Num());
+	}
+
+	const bool bWriteSucceeded = Writer->Close() && !Writer->IsError();
+	Writer.Reset();
+
+	if (!bWriteSucceeded || !IFileManager::Get().Move(*Path, *TempPath, true, true))
+	{
+		IFileManager::Get().Delete(*TempPath);
+		return false;
+	}
+
+	Evict(FPaths::GetPath(Path), Path);
+	return true;
+}
+
+void FHexGridCache::Evict(const FString& Directory, const FString& KeepPath)
+{
+	struct FCacheFile
+	{
+		FString Path;
+		FDateTime TimeStamp;
+		int64 Size = 0;
+	};
+
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *(Directory / TEXT("*.hexgrid")), true, false);
+
+	TArray<FCacheFile> Files;
+	for (const FString& FileName : FileNames)
+	{
+		FCacheFile& File = Files.AddDefaulted_GetRef();
+		File.Path = Directory / FileName;
+		File.TimeStamp = IFileManager::Get().GetTimeStamp(*File.Path);
+		File.Size = IFileManager::Get().FileSize(*File.Path);
+	}
+
+	Files.Sort([](const FCacheFile& A, const FCacheFile& B) { return A.TimeStamp > B.TimeStamp; });
+
+	int32 NumKept = 0;
+	int64 KeptBytes = 0;
+	for (const FCacheFile& File : Files)
+	{
+		const bool bKeep = File.Path == KeepPath || (NumKept < MaxFiles && KeptBytes + File.Size <= MaxBytes);
+
+		// Another grid may still map the file, it then stays until a later write evicts it
+		if (bKeep || !IFileManager::Get().Delete(*File.Path, false, false, true))
+		{
+			++NumKept;
+			KeptBytes += FMath::Max<int64>(File.Size, 0);
+		}
+	}
+}
@@ -0,0 +1,15 @@
+#include "HexGridSettings.h"
+
+void UHexGridSettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject)) return;
+
+	const float OddRowShift = TileHorizontalOffset * 0.5f;
+	if (!FMath::IsNearlyEqual(OddRowHorizontalOffset, OddRowShift, 0.01f))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("HexGridSettings: OddRowHorizontalOffset %f is ignored, odd rows are shifted by half of TileHorizontalOffset (%f)"),
+			OddRowHorizontalOffset, OddRowShift);
+	}
+}
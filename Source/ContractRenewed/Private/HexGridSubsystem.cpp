@@ -1,11 +1,566 @@
 #include "HexGridSubsystem.h"
 #include "HexGridSettings.h"
+#include "HexIterators.h"
 #include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "GameFramework/Actor.h"
+#include "Engine/HitResult.h"
+#include "Misc/ScopeLock.h"
 
-void UHexGridSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+namespace HexGridSubsystem
 {
-	Super::Initialize(Collection);
+	void ConfigureWrapper(UFastNoiseWrapper* NoiseWrapper, const FHexNoiseSettings& NoiseSettings)
+	{
+		NoiseWrapper->SetupFastNoise(
+			NoiseSettings.NoiseType, NoiseSettings.Seed, NoiseSettings.Frequency, NoiseSettings.Interp,
+			NoiseSettings.FractalType, NoiseSettings.Octaves, NoiseSettings.Lacunarity, NoiseSettings.Gain,
+			NoiseSettings.CellularJitter, NoiseSettings.CellularDistanceFunction, NoiseSettings.CellularReturnType);
+	}
 
-	NoiseWrapperLvl1 = NewObject<UFastNoiseWrapper>(this);
-	NoiseWrapperLvl1->SetupFastNoise();
+	// Times the per-sample wrapper against the batch path on odd-row hex layouts of 1k to 1M tiles
+	void BenchmarkNoise(const TArray<FString>& Args, UWorld* World)
+	{
+		UHexGridSubsystem* Subsystem = World ? World->GetSubsystem<UHexGridSubsystem>() : nullptr;
+		if (!Subsystem) return;
+
+		const UHexGridSettings* Settings = GetDefault<UHexGridSettings>();
+
+		// The plugin wrapper stays the reference the batch path is checked against
+		UFastNoiseWrapper* NoiseWrapper = NewObject<UFastNoiseWrapper>(GetTransientPackage());
+
+		for (const EFastNoise_NoiseType NoiseType : { EFastNoise_NoiseType::Simplex, EFastNoise_NoiseType::SimplexFractal })
+		{
+			FHexNoiseSettings NoiseSettings;
+			NoiseSettings.NoiseType = NoiseType;
+			ConfigureWrapper(NoiseWrapper, NoiseSettings);
+
+			for (const int32 NumTiles : { 1000, 10000, 100000, 1000000 })
+			{
+				const int32 Width = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(NumTiles)));
+
+				TArray<float> X, Y, Reference, Batched;
+				X.SetNumUninitialized(NumTiles);
+				Y.SetNumUninitialized(NumTiles);
+				Reference.SetNumUninitialized(NumTiles);
+				Batched.SetNumUninitialized(NumTiles);
+
+				for (int32 i = 0; i < NumTiles; ++i)
+				{
+					const FVector2f TilePos = FHexGridLayout::OffsetToWorld(FHexOffset(i % Width, i / Width), Settings->GetSpacing());
+					X[i] = TilePos.X;
+					Y[i] = TilePos.Y;
+				}
+
+				const double PerSampleStart = FPlatformTime::Seconds();
+				for (int32 i = 0; i < NumTiles; ++i)
+				{
+					Reference[i] = NoiseWrapper->GetNoise2D(X[i], Y[i]);
+				}
+				const double PerSampleMs = (FPlatformTime::Seconds() - PerSampleStart) * 1000.0;
+
+				const double BatchStart = FPlatformTime::Seconds();
+				Subsystem->SampleNoise2D(NoiseSettings, X, Y, Batched);
+				const double BatchMs = (FPlatformTime::Seconds() - BatchStart) * 1000.0;
+
+				float MaxError = 0.f;
+				for (int32 i = 0; i < NumTiles; ++i)
+				{
+					MaxError = FMath::Max(MaxError, FMath::Abs(Reference[i] - Batched[i]));
+				}
+
+				UE_LOG(LogTemp, Display, TEXT("HexGrid noise %s %7d tiles: per-sample %8.3f ms, batch %8.3f ms (x%.2f), max error %g"),
+					*UEnum::GetValueAsString(NoiseType), NumTiles, PerSampleMs, BatchMs,
+					BatchMs > 0.0 ? PerSampleMs / BatchMs : 0.0, MaxError);
+			}
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchmarkNoiseCommand(
+		TEXT("HexGrid.BenchmarkNoise"),
+		TEXT("Compares per-sample and batched hex grid noise sampling from 1k to 1M tiles"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchmarkNoise));
+
+	// Times the range and ring iterators against filtering every tile by distance, on a standalone 256 x 256 store
+	void BenchmarkIterators(const TArray<FString>& Args)
+	{
+		constexpr int32 GridSize = 256;
+		constexpr int32 NumQueries = 200;
+
+		FHexTileStore TileStore;
+		TileStore.Reset(16, 1.f, {});
+		TileStore.SetWorldLayout(FVector::ZeroVector, GetDefault<UHexGridSettings>()->GetSpacing());
+		for (int32 y = 0; y < GridSize; ++y)
+		{
+			for (int32 x = 0; x < GridSize; ++x)
+			{
+				const FIntPoint TileCoord(x, y);
+				const int32 ChunkBase = TileStore.AddChunk(TileStore.GetChunkCoord(TileCoord));
+				TileStore.SetTile(ChunkBase + TileStore.GetLocalIndex(TileCoord), 0.f, 0, INDEX_NONE);
+			}
+		}
+
+		// Centres reach past the edges so the clipping is part of what gets timed
+		FRandomStream Random(GridSize);
+		TArray<FIntPoint> Centres;
+		for (int32 i = 0; i < NumQueries; ++i)
+		{
+			Centres.Add(FIntPoint(Random.RandRange(-8, GridSize + 8), Random.RandRange(-8, GridSize + 8)));
+		}
+
+		// Tile counts and index sums of both sides have to agree, otherwise the iterator is wrong rather than fast
+		auto RunNaive = [&TileStore, &Centres](int32 Radius, bool bRing, int64& OutCount, int64& OutSum)
+		{
+			for (const FIntPoint& Centre : Centres)
+			{
+				TileStore.ForEachTile([&](int32 TileIndex, const FIntPoint& TileCoord)
+				{
+					const int32 Distance = FHexGridLayout::OffsetDistance(FHexOffset(Centre), FHexOffset(TileCoord));
+					if (bRing ? Distance == Radius : Distance <= Radius)
+					{
+						++OutCount;
+						OutSum += TileIndex;
+					}
+				});
+			}
+		};
+
+		auto RunIterator = [&TileStore, &Centres](int32 Radius, bool bRing, int64& OutCount, int64& OutSum)
+		{
+			for (const FIntPoint& Centre : Centres)
+			{
+				if (bRing)
+				{
+					for (FHexTileRingIterator It(TileStore, Centre, Radius); It; ++It)
+					{
+						++OutCount;
+						OutSum += It.GetTileIndex();
+					}
+				}
+				else
+				{
+					for (FHexTileRangeIterator It(TileStore, Centre, Radius); It; ++It)
+					{
+						++OutCount;
+						OutSum += It.GetTileIndex();
+					}
+				}
+			}
+		};
+
+		for (const bool bRing : { false, true })
+		{
+			for (const int32 Radius : { 1, 2, 4, 8, 16, 32 })
+			{
+				int64 NaiveCount = 0, NaiveSum = 0, Count = 0, Sum = 0;
+
+				const double NaiveStart = FPlatformTime::Seconds();
+				RunNaive(Radius, bRing, NaiveCount, NaiveSum);
+				const double NaiveMs = (FPlatformTime::Seconds() - NaiveStart) * 1000.0;
+
+				const double IteratorStart = FPlatformTime::Seconds();
+				RunIterator(Radius, bRing, Count, Sum);
+				const double IteratorMs = (FPlatformTime::Seconds() - IteratorStart) * 1000.0;
+
+				UE_LOG(LogTemp, Display, TEXT("HexGrid %s radius %2d x%d: naive scan %8.3f ms, iterator %8.3f ms (x%.1f), %lld tiles%s"),
+					bRing ? TEXT("ring ") : TEXT("range"), Radius, NumQueries, NaiveMs, IteratorMs,
+					IteratorMs > 0.0 ? NaiveMs / IteratorMs : 0.0, Count,
+					Count == NaiveCount && Sum == NaiveSum ? TEXT("") : TEXT(", MISMATCH"));
+			}
+		}
+
+		// Nothing naive to hold these against, the spiral has to agree with the range and lines are timed alone
+		int64 SpiralCount = 0, RangeCount = 0, RangeSum = 0, LineTiles = 0;
+		const double SpiralStart = FPlatformTime::Seconds();
+		for (const FIntPoint& Centre : Centres)
+		{
+			for (FHexTileSpiralIterator It(TileStore, Centre, 16); It; ++It)
+			{
+				++SpiralCount;
+			}
+		}
+		const double SpiralMs = (FPlatformTime::Seconds() - SpiralStart) * 1000.0;
+		RunIterator(16, false, RangeCount, RangeSum);
+
+		const double LineStart = FPlatformTime::Seconds();
+		for (int32 i = 1; i < Centres.Num(); ++i)
+		{
+			for (FHexTileLineIterator It(TileStore, Centres[i - 1], Centres[i]); It; ++It)
+			{
+				++LineTiles;
+			}
+		}
+		const double LineMs = (FPlatformTime::Seconds() - LineStart) * 1000.0;
+
+		UE_LOG(LogTemp, Display, TEXT("HexGrid spiral radius 16 x%d: %8.3f ms, %lld tiles%s. Lines x%d: %8.3f ms, %lld tiles"),
+			NumQueries, SpiralMs, SpiralCount, SpiralCount == RangeCount ? TEXT("") : TEXT(", MISMATCH"),
+			NumQueries - 1, LineMs, LineTiles);
+	}
+
+	static FAutoConsoleCommandWithArgs BenchmarkIteratorsCommand(
+		TEXT("HexGrid.BenchmarkIterators"),
+		TEXT("Compares hex range and ring iterators against a distance filter over every tile"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkIterators));
+}
+
+TSharedRef<const FHexNoiseGenerator> UHexGridSubsystem::GetNoiseGenerator(const FHexNoiseSettings& NoiseSettings)
+{
+	FScopeLock Lock(&NoiseGeneratorsLock);
+
+	if (const TSharedRef<const FHexNoiseGenerator>* NoiseGenerator = NoiseGenerators.Find(NoiseSettings))
+		return *NoiseGenerator;
+
+	return NoiseGenerators.Add(NoiseSettings, MakeShared<const FHexNoiseGenerator>(NoiseSettings));
+}
+
+void UHexGridSubsystem::SampleNoise2D(const FHexNoiseSettings& NoiseSettings, TConstArrayView<float> X, TConstArrayView<float> Y, TArrayView<float> OutHeights)
+{
+	GetNoiseGenerator(NoiseSettings)->GetNoise2DBatch(X, Y, OutHeights);
+}
+
+FHexTileStore& UHexGridSubsystem::GetTileStore(const AActor* Grid)
+{
+	TUniquePtr<FHexTileStore>& TileStore = TileStores.FindOrAdd(Grid);
+	if (!TileStore)
+	{
+		TileStore = MakeUnique<FHexTileStore>();
+	}
+	return *TileStore;
+}
+
+const FHexTileStore* UHexGridSubsystem::FindTileStore(const AActor* Grid) const
+{
+	const TUniquePtr<FHexTileStore>* TileStore = TileStores.Find(Grid);
+	return TileStore ? TileStore->Get() : nullptr;
+}
+
+void UHexGridSubsystem::RemoveTileStore(const AActor* Grid)
+{
+	TileStores.Remove(Grid);
+	LineOfSightCaches.Remove(Grid);
+	FogOfWars.Remove(Grid);
+	InfluenceMaps.Remove(Grid);
+	Occupancies.Remove(Grid);
+
+	const TObjectKey<AActor> GridKey(Grid);
+	for (auto It = Occupants.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Grid == GridKey)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = InstanceComponents.CreateIterator(); It; ++It)
+	{
+		if (It.Value().Grid == GridKey)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FHexFogOfWar& UHexGridSubsystem::GetFogOfWar(const AActor* Grid)
+{
+	TUniquePtr<FHexFogOfWar>& FogOfWar = FogOfWars.FindOrAdd(Grid);
+	if (!FogOfWar)
+	{
+		FogOfWar = MakeUnique<FHexFogOfWar>();
+	}
+	return *FogOfWar;
+}
+
+const FHexFogOfWar* UHexGridSubsystem::FindFogOfWar(const AActor* Grid) const
+{
+	const TUniquePtr<FHexFogOfWar>* FogOfWar = FogOfWars.Find(Grid);
+	return FogOfWar ? FogOfWar->Get() : nullptr;
+}
+
+FHexInfluenceMap& UHexGridSubsystem::GetInfluenceMap(const AActor* Grid)
+{
+	TUniquePtr<FHexInfluenceMap>& InfluenceMap = InfluenceMaps.FindOrAdd(Grid);
+	if (!InfluenceMap)
+	{
+		InfluenceMap = MakeUnique<FHexInfluenceMap>();
+	}
+	return *InfluenceMap;
+}
+
+const FHexInfluenceMap* UHexGridSubsystem::FindInfluenceMap(const AActor* Grid) const
+{
+	const TUniquePtr<FHexInfluenceMap>* InfluenceMap = InfluenceMaps.Find(Grid);
+	return InfluenceMap ? InfluenceMap->Get() : nullptr;
+}
+
+void UHexGridSubsystem::RegisterInstanceComponent(const AActor* Grid, const UPrimitiveComponent* Component, uint8 MeshSlot)
+{
+	if (!Grid || !Component) return;
+
+	FInstanceComponentInfo& Info = InstanceComponents.FindOrAdd(Component);
+	Info.Grid = Grid;
+	Info.MeshSlot = MeshSlot;
+}
+
+const FHexOccupancy* UHexGridSubsystem::FindOccupancy(const AActor* Grid) const
+{
+	return Occupancies.Find(Grid);
+}
+
+FHexTileRef UHexGridSubsystem::UpdateOccupant(AActor* Actor, const FVector& Location)
+{
+	const FHexTileRef Tile = FindTileAtLocation(Location);
+	if (!Actor) return Tile;
+
+	if (!Tile.IsValid() || !Tile.Grid)
+	{
+		RemoveOccupant(Actor);
+		return Tile;
+	}
+
+	const TObjectKey<AActor> GridKey(Tile.Grid);
+	const FIntPoint TileCoord = Tile.GetCoord();
+
+	FOccupantInfo* Info = Occupants.Find(Actor);
+	if (Info && Info->Grid == GridKey)
+	{
+		Occupancies.FindOrAdd(GridKey).Move(Actor, Info->Tile, TileCoord);
+		Info->Tile = TileCoord;
+		return Tile;
+	}
+
+	if (Info)
+	{
+		RemoveOccupant(Actor);
+	}
+
+	Occupancies.FindOrAdd(GridKey).Add(Actor, TileCoord);
+	Occupants.Add(Actor, { GridKey, TileCoord });
+	return Tile;
+}
+
+void UHexGridSubsystem::RemoveOccupant(const AActor* Actor)
+{
+	FOccupantInfo Info;
+	if (!Occupants.RemoveAndCopyValue(Actor, Info)) return;
+
+	if (FHexOccupancy* Occupancy = Occupancies.Find(Info.Grid))
+	{
+		Occupancy->Remove(Actor, Info.Tile);
+	}
+}
+
+bool UHexGridSubsystem::FindOccupantsInRadius(const FVector& Location, float Radius, TArray<AActor*>& OutActors) const
+{
+	OutActors.Reset();
+
+	const FHexTileRef Tile = FindTileAtLocation(Location);
+	const FHexOccupancy* Occupancy = Tile.IsValid() ? FindOccupancy(Tile.Grid) : nullptr;
+	if (!Occupancy) return false;
+
+	// A hex N steps away is at least N of the shorter spacing off, and Location and every actor sit within a corner of their centres
+	const FHexSpacing& Spacing = Tile.Store->GetSpacing();
+	const float MinStep = FMath::Min(Spacing.Column, Spacing.Row);
+	const int32 TileRadius = FMath::FloorToInt((Radius + 2.f * Spacing.Row / 1.5f) / MinStep);
+
+	const double RadiusSquared = FMath::Square(Radius);
+	Occupancy->ForEachOccupantInRange(Tile.GetCoord(), TileRadius, [&OutActors, &Location, RadiusSquared](AActor* Actor, const FIntPoint&)
+	{
+		if (FVector::DistSquared(Actor->GetActorLocation(), Location) <= RadiusSquared)
+		{
+			OutActors.Add(Actor);
+		}
+	});
+	return true;
+}
+
+bool UHexGridSubsystem::FindOccupantsInTileRange(const FVector& Location, int32 TileRadius, TArray<AActor*>& OutActors) const
+{
+	OutActors.Reset();
+
+	const FHexTileRef Tile = FindTileAtLocation(Location);
+	const FHexOccupancy* Occupancy = Tile.IsValid() ? FindOccupancy(Tile.Grid) : nullptr;
+	if (!Occupancy) return false;
+
+	Occupancy->ForEachOccupantInRange(Tile.GetCoord(), TileRadius, [&OutActors](AActor* Actor, const FIntPoint&)
+	{
+		OutActors.Add(Actor);
+	});
+	return true;
+}
+
+FHexTileRef UHexGridSubsystem::FindTileAtLocation(const FVector& WorldLocation) const
+{
+	FHexTileRef Result;
+
+	// There is normally a single grid, so trying each store beats keeping a spatial index of grids
+	for (const TPair<TObjectKey<AActor>, TUniquePtr<FHexTileStore>>& Pair : TileStores)
+	{
+		const int32 TileIndex = Pair.Value->FindTileAtLocation(WorldLocation);
+		if (TileIndex != INDEX_NONE)
+		{
+			Result.Grid = Pair.Key.ResolveObjectPtr();
+			Result.Store = Pair.Value.Get();
+			Result.TileIndex = TileIndex;
+			break;
+		}
+	}
+
+	return Result;
+}
+
+bool UHexGridSubsystem::GetGroundHeightAt(double X, double Y, float& OutHeight) const
+{
+	const FHexTileRef Tile = FindTileAtLocation(FVector(X, Y, 0.0));
+	if (!Tile.IsValid()) return false;
+
+	OutHeight = Tile.Store->GetGroundHeight(Tile.TileIndex);
+	return true;
+}
+
+int32 UHexGridSubsystem::GetGroundHeights(TConstArrayView<FVector2D> Locations, TArrayView<float> OutHeights, float DefaultHeight) const
+{
+	check(OutHeights.Num() >= Locations.Num());
+
+	for (int32 i = 0; i < Locations.Num(); ++i)
+	{
+		OutHeights[i] = DefaultHeight;
+	}
+
+	// Each store only fills what the ones before it missed
+	TBitArray<> Found(false, Locations.Num());
+	int32 NumFound = 0;
+	for (const TPair<TObjectKey<AActor>, TUniquePtr<FHexTileStore>>& Pair : TileStores)
+	{
+		NumFound += Pair.Value->GetGroundHeights(Locations, OutHeights, Found);
+		if (NumFound == Locations.Num()) break;
+	}
+
+	return NumFound;
+}
+
+bool UHexGridSubsystem::HasLineOfSight(const FVector& From, const FVector& To) const
+{
+	for (const TPair<TObjectKey<AActor>, TUniquePtr<FHexTileStore>>& Pair : TileStores)
+	{
+		if (!FHexLineOfSightCache::Trace(*Pair.Value, From, To)) return false;
+	}
+	return true;
+}
+
+bool UHexGridSubsystem::HasTileLineOfSight(const FVector& From, const FVector& To, float EyeHeight)
+{
+	const FHexTileRef FromTile = FindTileAtLocation(From);
+	const FHexTileRef ToTile = FindTileAtLocation(To);
+	if (!FromTile.IsValid() || !ToTile.IsValid() || FromTile.Store != ToTile.Store)
+		return HasLineOfSight(From, To);
+
+	FHexLineOfSightCache& Cache = LineOfSightCaches.FindOrAdd(FromTile.Grid);
+	return Cache.HasLineOfSight(*FromTile.Store, FromTile.GetCoord(), ToTile.GetCoord(), EyeHeight);
+}
+
+bool UHexGridSubsystem::IsLocationVisibleToPlayer(const FVector& Location, int32 PlayerId) const
+{
+	const FHexTileRef Tile = FindTileAtLocation(Location);
+	const FHexFogOfWar* FogOfWar = Tile.IsValid() ? FindFogOfWar(Tile.Grid) : nullptr;
+	return FogOfWar && FogOfWar->IsTileVisible(PlayerId, Tile.GetCoord());
+}
+
+bool UHexGridSubsystem::IsLocationExploredByPlayer(const FVector& Location, int32 PlayerId) const
+{
+	const FHexTileRef Tile = FindTileAtLocation(Location);
+	const FHexFogOfWar* FogOfWar = Tile.IsValid() ? FindFogOfWar(Tile.Grid) : nullptr;
+	return FogOfWar && FogOfWar->IsTileExplored(PlayerId, Tile.GetCoord());
+}
+
+bool UHexGridSubsystem::IsLocationRelevantToPlayers(const FVector& Location) const
+{
+	const FHexTileRef Tile = FindTileAtLocation(Location);
+	const FHexFogOfWar* FogOfWar = Tile.IsValid() ? FindFogOfWar(Tile.Grid) : nullptr;
+	return !FogOfWar || FogOfWar->IsTileVisibleToAny(Tile.GetCoord());
+}
+
+float UHexGridSubsystem::SampleInfluence(EHexInfluenceLayer Layer, const FVector& Location) const
+{
+	float Value = 0.f;
+	SampleInfluences(Layer, MakeArrayView(&Location, 1), MakeArrayView(&Value, 1));
+	return Value;
+}
+
+void UHexGridSubsystem::SampleInfluences(EHexInfluenceLayer Layer, TConstArrayView<FVector> Locations, TArrayView<float> OutValues) const
+{
+	check(OutValues.Num() >= Locations.Num());
+
+	for (int32 i = 0; i < Locations.Num(); ++i)
+	{
+		OutValues[i] = 0.f;
+	}
+
+	// Missing tiles read as zero in the maps, so the tile coordinate alone is enough
+	for (const TPair<TObjectKey<AActor>, TUniquePtr<FHexInfluenceMap>>& Pair : InfluenceMaps)
+	{
+		const FHexTileStore* TileStore = FindTileStore(Pair.Key.ResolveObjectPtr());
+		if (!TileStore) continue;
+
+		for (int32 i = 0; i < Locations.Num(); ++i)
+		{
+			const FIntPoint TileCoord = TileStore->WorldToTileCoord(Locations[i]);
+			if (Pair.Value->IsInWindow(TileCoord))
+			{
+				OutValues[i] = Pair.Value->Sample(Layer, TileCoord);
+			}
+		}
+	}
+}
+
+void UHexGridSubsystem::AddInfluence(EHexInfluenceLayer Layer, const FVector& Location, float Amount)
+{
+	const FHexTileRef Tile = FindTileAtLocation(Location);
+	if (!Tile.IsValid()) return;
+
+	TUniquePtr<FHexInfluenceMap>* InfluenceMap = InfluenceMaps.Find(Tile.Grid);
+	if (InfluenceMap)
+	{
+		(*InfluenceMap)->AddSource(Layer, Tile.GetCoord(), Amount);
+	}
+}
+
+bool UHexGridSubsystem::FindInfluencePeak(EHexInfluenceLayer Layer, const FVector& Location, int32 Radius, bool bLowest, FVector& OutLocation) const
+{
+	const FHexTileRef Tile = FindTileAtLocation(Location);
+	const FHexInfluenceMap* InfluenceMap = Tile.IsValid() ? FindInfluenceMap(Tile.Grid) : nullptr;
+	if (!InfluenceMap) return false;
+
+	int32 BestTile = INDEX_NONE;
+	float BestValue = 0.f;
+	for (FHexTileRangeIterator It(*Tile.Store, Tile.GetCoord(), Radius); It; ++It)
+	{
+		const float Value = InfluenceMap->Sample(Layer, It.GetTileCoord());
+		if (BestTile == INDEX_NONE || (bLowest ? Value < BestValue : Value > BestValue))
+		{
+			BestTile = It.GetTileIndex();
+			BestValue = Value;
+		}
+	}
+
+	if (BestTile == INDEX_NONE) return false;
+
+	OutLocation = Tile.Store->GetTileLocation(BestTile);
+	OutLocation.Z = Tile.Store->GetGroundHeight(BestTile);
+	return true;
+}
+
+FHexTileRef UHexGridSubsystem::FindTileFromHit(const FHitResult& Hit) const
+{
+	FHexTileRef Result;
+
+	const FInstanceComponentInfo* Info = InstanceComponents.Find(Hit.GetComponent());
+	if (!Info || Hit.Item == INDEX_NONE) return Result;
+
+	const TUniquePtr<FHexTileStore>* TileStore = TileStores.Find(Info->Grid);
+	if (!TileStore) return Result;
+
+	Result.Grid = Info->Grid.ResolveObjectPtr();
+	Result.Store = TileStore->Get();
+	Result.TileIndex = (*TileStore)->FindTileByInstance(Info->MeshSlot, Hit.Item);
+	return Result;
 }
@@ -0,0 +1,230 @@
+#include "HexInfluenceMap.h"
+#include "HexTileStore.h"
+#include "Async/ParallelFor.h"
+
+namespace HexInfluenceMap
+{
+	// Rows one worker diffuses in a go, enough to amortise scheduling on narrow windows
+	constexpr int32 RowsPerBlock = 16;
+
+	FORCEINLINE int32 GetCellIndex(const FIntPoint& MinTile, int32 Stride, const FIntPoint& TileCoord)
+	{
+		return (TileCoord.Y - MinTile.Y + 1) * Stride + TileCoord.X - MinTile.X + 1;
+	}
+}
+
+FHexInfluenceMap::~FHexInfluenceMap()
+{
+	WaitForStep();
+}
+
+void FHexInfluenceMap::SetWindow(const FIntPoint& InMinTile, const FIntPoint& InSize)
+{
+	WaitForStep();
+	FinishStep();
+
+	const FIntPoint NewSize(FMath::Max(InSize.X, 0), FMath::Max(InSize.Y, 0));
+	if (InMinTile == MinTile && NewSize == Size && !Current.IsEmpty()) return;
+
+	const int32 NewStride = Align(NewSize.X + 2, 4);
+	const int32 NewCellsPerLayer = NewStride * (NewSize.Y + 2);
+
+	TArray<float> NewCurrent;
+	TArray<float> NewPendingSources;
+	NewCurrent.SetNumZeroed(NumLayers * NewCellsPerLayer);
+	NewPendingSources.SetNumZeroed(NumLayers * NewCellsPerLayer);
+
+	// Influence already spread over tiles both windows cover carries over, so recentring doesn't reset it
+	const FIntPoint OverlapMin = FIntPoint(FMath::Max(MinTile.X, InMinTile.X), FMath::Max(MinTile.Y, InMinTile.Y));
+	const FIntPoint OverlapMax = FIntPoint(FMath::Min(MinTile.X + Size.X, InMinTile.X + NewSize.X), FMath::Min(MinTile.Y + Size.Y, InMinTile.Y + NewSize.Y));
+	for (int32 Layer = 0; Layer < NumLayers && !Current.IsEmpty(); ++Layer)
+	{
+		for (int32 Y = OverlapMin.Y; Y < OverlapMax.Y; ++Y)
+		{
+			for (int32 X = OverlapMin.X; X < OverlapMax.X; ++X)
+			{
+				const int32 OldIndex = Layer * CellsPerLayer + HexInfluenceMap::GetCellIndex(MinTile, Stride, FIntPoint(X, Y));
+				const int32 NewIndex = Layer * NewCellsPerLayer + HexInfluenceMap::GetCellIndex(InMinTile, NewStride, FIntPoint(X, Y));
+				NewCurrent[NewIndex] = Current[OldIndex];
+				NewPendingSources[NewIndex] = PendingSources[OldIndex];
+			}
+		}
+	}
+
+	MinTile = InMinTile;
+	Size = NewSize;
+	Stride = NewStride;
+	CellsPerLayer = NewCellsPerLayer;
+
+	Current = MoveTemp(NewCurrent);
+	PendingSources = MoveTemp(NewPendingSources);
+
+	// The borders of every buffer have to read as zero
+	Next.Reset();
+	Next.SetNumZeroed(NumLayers * CellsPerLayer);
+	Sources.Reset();
+	Sources.SetNumZeroed(NumLayers * CellsPerLayer);
+	Passable.Reset();
+	Passable.SetNumZeroed(CellsPerLayer);
+	bPassableValid = false;
+}
+
+bool FHexInfluenceMap::IsInWindow(const FIntPoint& TileCoord) const
+{
+	return TileCoord.X >= MinTile.X && TileCoord.Y >= MinTile.Y && TileCoord.X < MinTile.X + Size.X && TileCoord.Y < MinTile.Y + Size.Y;
+}
+
+void FHexInfluenceMap::SetLayerSettings(EHexInfluenceLayer Layer, const FHexInfluenceLayerSettings& InSettings)
+{
+	Settings[static_cast<int32>(Layer)] = InSettings;
+}
+
+void FHexInfluenceMap::AddSource(EHexInfluenceLayer Layer, const FIntPoint& TileCoord, float Amount)
+{
+	if (!IsInWindow(TileCoord)) return;
+
+	PendingSources[static_cast<int32>(Layer) * CellsPerLayer + GetCellIndex(TileCoord)] += Amount;
+}
+
+float FHexInfluenceMap::Sample(EHexInfluenceLayer Layer, const FIntPoint& TileCoord) const
+{
+	if (!IsInWindow(TileCoord)) return 0.f;
+
+	return Current[static_cast<int32>(Layer) * CellsPerLayer + GetCellIndex(TileCoord)];
+}
+
+bool FHexInfluenceMap::LaunchStep(const FHexTileStore& TileStore)
+{
+	if (IsStepRunning() || Size.X == 0 || Size.Y == 0) return false;
+
+	UpdatePassable(TileStore);
+
+	// Sources queued since the last launch go to this step, the game thread queues the next ones into the other buffer
+	Swap(Sources, PendingSources);
+	FMemory::Memzero(PendingSources.GetData(), PendingSources.Num() * sizeof(float));
+
+	for (int32 Layer = 0; Layer < NumLayers; ++Layer)
+	{
+		StepSettings[Layer] = Settings[Layer];
+	}
+
+	StepTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this]()
+	{
+		const int32 BlocksPerLayer = FMath::DivideAndRoundUp(Size.Y, HexInfluenceMap::RowsPerBlock);
+		ParallelFor(NumLayers * BlocksPerLayer, [this, BlocksPerLayer](int32 BlockIndex)
+		{
+			const int32 FirstRow = (BlockIndex % BlocksPerLayer) * HexInfluenceMap::RowsPerBlock;
+			DiffuseRows(BlockIndex / BlocksPerLayer, FirstRow, FMath::Min(FirstRow + HexInfluenceMap::RowsPerBlock, Size.Y));
+		});
+	});
+	return true;
+}
+
+bool FHexInfluenceMap::FinishStep()
+{
+	if (!StepTask.IsValid() || !StepTask.IsCompleted()) return false;
+
+	StepTask = UE::Tasks::FTask();
+	Swap(Current, Next);
+	++NumSteps;
+	return true;
+}
+
+void FHexInfluenceMap::WaitForStep()
+{
+	if (StepTask.IsValid())
+	{
+		StepTask.Wait();
+	}
+}
+
+SIZE_T FHexInfluenceMap::GetAllocatedSize() const
+{
+	return Current.GetAllocatedSize() + Next.GetAllocatedSize() + Sources.GetAllocatedSize() + PendingSources.GetAllocatedSize()
+		+ Passable.GetAllocatedSize();
+}
+
+int32 FHexInfluenceMap::GetCellIndex(const FIntPoint& TileCoord) const
+{
+	return HexInfluenceMap::GetCellIndex(MinTile, Stride, TileCoord);
+}
+
+void FHexInfluenceMap::UpdatePassable(const FHexTileStore& TileStore)
+{
+	if (bPassableValid && PassableRevision == TileStore.GetRevision()) return;
+
+	// Only chunks that changed since the last rebuild are reread
+	const int32 ChunkSize = TileStore.GetChunkSize();
+	const FIntPoint MinChunk = TileStore.GetChunkCoord(MinTile);
+	const FIntPoint MaxChunk = TileStore.GetChunkCoord(MinTile + Size - FIntPoint(1, 1));
+	for (int32 ChunkY = MinChunk.Y; ChunkY <= MaxChunk.Y; ++ChunkY)
+	{
+		for (int32 ChunkX = MinChunk.X; ChunkX <= MaxChunk.X; ++ChunkX)
+		{
+			const FIntPoint ChunkCoord(ChunkX, ChunkY);
+			if (bPassableValid && TileStore.GetChunkRevision(ChunkCoord) <= PassableRevision) continue;
+
+			const int32 ChunkBase = TileStore.FindChunkBase(ChunkCoord);
+			const int32 MinX = FMath::Max(ChunkX * ChunkSize, MinTile.X);
+			const int32 MinY = FMath::Max(ChunkY * ChunkSize, MinTile.Y);
+			const int32 MaxX = FMath::Min((ChunkX + 1) * ChunkSize, MinTile.X + Size.X);
+			const int32 MaxY = FMath::Min((ChunkY + 1) * ChunkSize, MinTile.Y + Size.Y);
+
+			for (int32 Y = MinY; Y < MaxY; ++Y)
+			{
+				for (int32 X = MinX; X < MaxX; ++X)
+				{
+					const FIntPoint TileCoord(X, Y);
+					const bool bOpen = ChunkBase != INDEX_NONE && TileStore.IsValidTile(ChunkBase + TileStore.GetLocalIndex(TileCoord));
+					Passable[GetCellIndex(TileCoord)] = bOpen ? 1.f : 0.f;
+				}
+			}
+		}
+	}
+
+	PassableRevision = TileStore.GetRevision();
+	bPassableValid = true;
+}
+
+void FHexInfluenceMap::DiffuseRows(int32 Layer, int32 FirstRow, int32 LastRow)
+{
+	const FHexInfluenceLayerSettings& LayerSettings = StepSettings[Layer];
+	const float Keep = (1.f - LayerSettings.Spread) * LayerSettings.Decay;
+	const float PerNeighbour = LayerSettings.Spread * LayerSettings.Decay / 6.f;
+
+	const VectorRegister4Float VKeep = VectorSetFloat1(Keep);
+	const VectorRegister4Float VPerNeighbour = VectorSetFloat1(PerNeighbour);
+
+	const int32 NumVectorized = Size.X & ~3;
+	for (int32 Row = FirstRow; Row < LastRow; ++Row)
+	{
+		// Odd rows sit half a tile right of even ones, so a tile meets the rows above and below at X - 1 and X on
+		// even rows and at X and X + 1 on odd rows
+		const int32 Shift = ((MinTile.Y + Row) & 1) ? 0 : -1;
+		const int32 RowCell = (Row + 1) * Stride + 1;
+		const int32 RowBase = Layer * CellsPerLayer + RowCell;
+
+		const float* Cur = Current.GetData() + RowBase;
+		const float* Above = Cur - Stride + Shift;
+		const float* Below = Cur + Stride + Shift;
+		const float* Source = Sources.GetData() + RowBase;
+		const float* Open = Passable.GetData() + RowCell;
+		float* Out = Next.GetData() + RowBase;
+
+		for (int32 X = 0; X < NumVectorized; X += 4)
+		{
+			VectorRegister4Float Sum = VectorAdd(VectorLoad(Cur + X - 1), VectorLoad(Cur + X + 1));
+			Sum = VectorAdd(Sum, VectorAdd(VectorLoad(Above + X), VectorLoad(Above + X + 1)));
+			Sum = VectorAdd(Sum, VectorAdd(VectorLoad(Below + X), VectorLoad(Below + X + 1)));
+
+			const VectorRegister4Float Value = VectorMultiplyAdd(Sum, VPerNeighbour, VectorMultiplyAdd(VectorLoad(Cur + X), VKeep, VectorLoad(Source + X)));
+			VectorStore(VectorMultiply(Value, VectorLoad(Open + X)), Out + X);
+		}
+
+		for (int32 X = NumVectorized; X < Size.X; ++X)
+		{
+			const float Sum = Cur[X - 1] + Cur[X + 1] + Above[X] + Above[X + 1] + Below[X] + Below[X + 1];
+			Out[X] = (Sum * PerNeighbour + Cur[X] * Keep + Source[X]) * Open[X];
+		}
+	}
+}
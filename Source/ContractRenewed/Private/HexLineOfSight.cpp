@@ -0,0 +1,158 @@
+#include "HexLineOfSight.h"
+#include "HexTileStore.h"
+
+namespace HexLineOfSight
+{
+	// Neighbour spacing of the regular unit hexes the walker works in
+	constexpr FHexSpacing UnitSpacing = FHexGridLayout::bPointy ? FHexSpacing(1.f, UE_SQRT_3 / 2.f) : FHexSpacing(UE_SQRT_3 / 2.f, 1.f);
+}
+
+FHexLineWalker::FHexLineWalker(const FHexTileStore& TileStore, const FVector& InStart, const FVector& InEnd)
+{
+	const FHexSpacing& Spacing = TileStore.GetSpacing();
+	Scale = FVector2f(HexLineOfSight::UnitSpacing.Column / Spacing.Column, HexLineOfSight::UnitSpacing.Row / Spacing.Row);
+
+	TileCoord = TileStore.WorldToTileCoord(InStart);
+	const FVector StartCentre = TileStore.GetOrigin() + TileStore.GetLocalLocation(TileCoord);
+
+	Start = FVector2f(InStart.X - StartCentre.X, InStart.Y - StartCentre.Y) * Scale;
+	Delta = FVector2f(InEnd.X - InStart.X, InEnd.Y - InStart.Y) * Scale;
+	StartZ = InStart.Z;
+	DeltaZ = InEnd.Z - InStart.Z;
+
+	StartAxial = Axial = FHexGridLayout::OffsetToAxial(FHexOffset(TileCoord));
+
+	// A walk only goes round a corner where two exits tie, this bound just guards against float noise looping it
+	const FHexAxial EndAxial = FHexGridLayout::OffsetToAxial(FHexOffset(TileStore.WorldToTileCoord(InEnd)));
+	StepsLeft = HexLayout::Distance(StartAxial, EndAxial) * 2 + 2;
+
+	FindExit();
+}
+
+FHexLineWalker& FHexLineWalker::operator++()
+{
+	if (ExitAlpha >= 1.f || ExitDirection == INDEX_NONE || --StepsLeft < 0)
+	{
+		bValid = false;
+		return *this;
+	}
+
+	Axial = HexLayout::Neighbour(Axial, ExitDirection);
+	TileCoord = FHexGridLayout::AxialToOffset(Axial).ToIntPoint();
+	EntryAlpha = ExitAlpha;
+	FindExit();
+	return *this;
+}
+
+void FHexLineWalker::FindExit()
+{
+	const FVector2f Centre = FHexGridLayout::AxialToWorld(Axial - StartAxial, HexLineOfSight::UnitSpacing);
+
+	ExitAlpha = 1.f;
+	ExitDirection = INDEX_NONE;
+	for (int32 Direction = 0; Direction < HexLayout::NumDirections; ++Direction)
+	{
+		// Only edges the segment heads towards can be left through, each one halfway to the neighbour's centre
+		const FVector2f Normal = FHexGridLayout::AxialToWorld(HexLayout::Directions[Direction], HexLineOfSight::UnitSpacing);
+		const float Speed = Delta | Normal;
+		if (Speed <= 0.f) continue;
+
+		const float Alpha = ((Centre + Normal * 0.5f - Start) | Normal) / Speed;
+		if (Alpha < ExitAlpha)
+		{
+			ExitAlpha = Alpha;
+			ExitDirection = Direction;
+		}
+	}
+
+	ExitAlpha = FMath::Max(ExitAlpha, EntryAlpha);
+}
+
+bool FHexLineOfSightCache::Trace(const FHexTileStore& TileStore, const FVector& From, const FVector& To, FIntPoint* OutBlockingTile)
+{
+	for (FHexLineWalker Walker(TileStore, From, To); Walker; ++Walker)
+	{
+		if (Walker.IsFirstTile() || Walker.IsLastTile()) continue;
+
+		const int32 TileIndex = TileStore.FindTile(Walker.GetTileCoord());
+		if (TileIndex == INDEX_NONE) continue;
+
+		if (TileStore.GetGroundHeight(TileIndex) > Walker.GetLowestHeight())
+		{
+			if (OutBlockingTile)
+			{
+				*OutBlockingTile = Walker.GetTileCoord();
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FHexLineOfSightCache::HasLineOfSight(const FHexTileStore& TileStore, const FIntPoint& FromTile, const FIntPoint& ToTile, float EyeHeight)
+{
+	if (FromTile == ToTile) return true;
+
+	// Ordered so both directions share the entry and always trace the same way
+	const bool bSwap = FromTile.X > ToTile.X || (FromTile.X == ToTile.X && FromTile.Y > ToTile.Y);
+	const FIntPoint& First = bSwap ? ToTile : FromTile;
+	const FIntPoint& Second = bSwap ? FromTile : ToTile;
+	const int32 EyeSteps = FMath::RoundToInt32(EyeHeight / EyeHeightStep);
+	const TTuple<FIntPoint, FIntPoint, int32> Key(First, Second, EyeSteps);
+
+	if (FEntry* Entry = Entries.Find(Key))
+	{
+		if (IsEntryCurrent(TileStore, *Entry))
+		{
+			++NumHits;
+			return Entry->bVisible;
+		}
+	}
+
+	const int32 FirstIndex = TileStore.FindTile(First);
+	const int32 SecondIndex = TileStore.FindTile(Second);
+	if (FirstIndex == INDEX_NONE || SecondIndex == INDEX_NONE) return true;
+
+	++NumMisses;
+
+	FVector From = TileStore.GetTileLocation(FirstIndex);
+	From.Z = TileStore.GetGroundHeight(FirstIndex) + EyeSteps * EyeHeightStep;
+	FVector To = TileStore.GetTileLocation(SecondIndex);
+	To.Z = TileStore.GetGroundHeight(SecondIndex) + EyeSteps * EyeHeightStep;
+
+	if (Entries.Num() >= MaxEntries)
+	{
+		Entries.Reset();
+	}
+
+	// Lines between offset coordinates can stray half a tile outside their box, one tile of margin covers that
+	FEntry& Entry = Entries.FindOrAdd(Key);
+	Entry.Revision = TileStore.GetRevision();
+	Entry.MinChunk = TileStore.GetChunkCoord(FIntPoint(FMath::Min(First.X, Second.X) - 1, FMath::Min(First.Y, Second.Y) - 1));
+	Entry.MaxChunk = TileStore.GetChunkCoord(FIntPoint(FMath::Max(First.X, Second.X) + 1, FMath::Max(First.Y, Second.Y) + 1));
+	Entry.bVisible = Trace(TileStore, From, To);
+	return Entry.bVisible;
+}
+
+void FHexLineOfSightCache::Reset()
+{
+	Entries.Reset();
+}
+
+bool FHexLineOfSightCache::IsEntryCurrent(const FHexTileStore& TileStore, FEntry& Entry)
+{
+	if (Entry.Revision == TileStore.GetRevision()) return true;
+
+	for (int32 ChunkY = Entry.MinChunk.Y; ChunkY <= Entry.MaxChunk.Y; ++ChunkY)
+	{
+		for (int32 ChunkX = Entry.MinChunk.X; ChunkX <= Entry.MaxChunk.X; ++ChunkX)
+		{
+			if (TileStore.GetChunkRevision(FIntPoint(ChunkX, ChunkY)) > Entry.Revision)
+				return false;
+		}
+	}
+
+	// Nothing under the line changed, the next lookups skip the chunk checks until the store changes again
+	Entry.Revision = TileStore.GetRevision();
+	return true;
+}
@@ -1,97 +1,2362 @@
 ﻿#include "HexManager.h"
 #include "HexGridSubsystem.h"
+#include "HexGridCache.h"
 #include "DrawDebugHelpers.h"
 #include "NavigationSystem.h"
 #include "AIController.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/WorldSettings.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Hash/xxhash.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Engine/StaticMesh.h"
+#include "Camera/PlayerCameraManager.h"
+#include "MeshDescription.h"
+#include "Engine/Texture2D.h"
+
+namespace HexManagerCommands
+{
+    void BenchmarkCollision(const TArray<FString>& Args, UWorld* World)
+    {
+        for (TActorIterator<AHexManager> It(World); It; ++It)
+        {
+            It->BenchmarkCollision();
+        }
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs BenchmarkCollisionCommand(
+        TEXT("HexGrid.BenchmarkCollision"),
+        TEXT("Compares physics memory and floor sweep cost of per-instance and merged chunk collision on every hex grid"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchmarkCollision));
+}
 
 AHexManager::AHexManager()
 {
-    PrimaryActorTick.bCanEverTick = false;
-    bRunConstructionScriptOnDrag = false;
+    PrimaryActorTick.bCanEverTick = false;
+    bRunConstructionScriptOnDrag = false;
+
+    RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComp"));
+
+    GrassMeshComp = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("GrassMeshComp"));
+    GrassMeshComp->SetupAttachment(RootComponent);
+
+    WaterMeshComp = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("WaterMeshComp"));
+    WaterMeshComp->SetupAttachment(RootComponent);
+
+    GrassMeshComp->SetMobility(EComponentMobility::Movable);
+    WaterMeshComp->SetMobility(EComponentMobility::Movable);
+
+    // Instances are committed in bulk, the cluster tree is rebuilt once per commit in FinishInstanceUpdates
+    GrassMeshComp->bAutoRebuildTreeOnInstanceChanges = false;
+    WaterMeshComp->bAutoRebuildTreeOnInstanceChanges = false;
+
+    MeshComps = { GrassMeshComp, WaterMeshComp };
+
+    PromotedTileClass = AHexTile::StaticClass();
+
+    InfluenceLayers[static_cast<int32>(EHexInfluenceLayer::EnemyDensity)].SourceTag = TEXT("Enemy");
+    InfluenceLayers[static_cast<int32>(EHexInfluenceLayer::PickupValue)].SourceTag = TEXT("Pickup");
+
+    Settings = GetMutableDefault<UHexGridSettings>();
+    check(Settings);
+}
+
+void AHexManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UHexGridSubsystem* Subsystem = GetWorld() ? GetWorld()->GetSubsystem<UHexGridSubsystem>() : nullptr)
+    {
+        Subsystem->RemoveTileStore(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void AHexManager::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (!SetupBiomes())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: every biome needs a mesh"), *GetName());
+    }
+
+    if (bUseProxyMeshes)
+    {
+        GetWorldTimerManager().SetTimer(ProxyTimer, this, &AHexManager::UpdateChunkProxies, ProxyUpdateInterval, true);
+    }
+
+    if (bRebaseGrid && bUseChunkStreaming && bUnboundedGrid)
+    {
+        GetWorldTimerManager().SetTimer(RebaseTimer, this, &AHexManager::UpdateGridAnchor, RebaseCheckInterval, true);
+    }
+
+    if (bUseFogOfWar)
+    {
+        GetWorldTimerManager().SetTimer(FogTimer, this, &AHexManager::UpdateFogOfWar, FogUpdateInterval, true);
+    }
+
+    if (bUseInfluenceMaps)
+    {
+        GetWorldTimerManager().SetTimer(InfluenceTimer, this, &AHexManager::UpdateInfluenceMaps, InfluenceStepInterval, true);
+    }
+
+    if (bUseMinimap)
+    {
+        GetWorldTimerManager().SetTimer(MinimapTimer, this, &AHexManager::UpdateMinimap, MinimapUpdateInterval, true);
+    }
+
+    if (!bUseChunkStreaming && BakedGrid.Key != 0)
+    {
+        if (RestoreBakedGrid())
+        {
+            SpawnFromPlan(BakedGrid.SpawnPlan);
+            return;
+        }
+
+        UE_LOG(LogTemp, Warning, TEXT("%s: baked grid is out of date, rebake the level"), *GetName());
+    }
+
+    if (bUseChunkStreaming)
+    {
+        // Instances saved with the level aren't tracked by any chunk, streaming rebuilds them around the players
+        const FHexTileStore* TileStore = GetTileStore();
+        if (TileStore && TileStore->GetNumChunks() == 0)
+        {
+            for (UHierarchicalInstancedStaticMeshComponent* MeshComp : MeshComps)
+            {
+                MeshComp->ClearInstances();
+            }
+            ResetTileStore();
+        }
+
+        GetWorldTimerManager().SetTimer(StreamingTimer, this, &AHexManager::UpdateStreamedChunks, StreamingUpdateInterval, true);
+    }
+}
+
+void AHexManager::DestroyTiles()
+{
+    for (UHierarchicalInstancedStaticMeshComponent* MeshComp : MeshComps)
+    {
+        if (IsValid(MeshComp))
+            MeshComp->ClearInstances();
+    }
+
+    for (AActor* Spawned : SpawnedActors)
+    {
+        if (IsValid(Spawned))
+            Spawned->Destroy();
+    }
+
+    SpawnedActors.Empty();
+
+    for (const TPair<FIntPoint, AHexTile*>& Pair : PromotedTiles)
+    {
+        ReleaseTileActor(Pair.Value);
+    }
+    PromotedTiles.Empty();
+
+    TArray<FIntPoint> CollisionChunks;
+    ChunkCollision.GenerateKeyArray(CollisionChunks);
+    for (const FIntPoint& ChunkCoord : CollisionChunks)
+    {
+        ReleaseChunkCollision(ChunkCoord);
+    }
+    DirtyCollisionChunks.Reset();
+
+    TArray<FIntPoint> ProxyChunks;
+    ChunkProxies.GenerateKeyArray(ProxyChunks);
+    for (const FIntPoint& ChunkCoord : ProxyChunks)
+    {
+        ReleaseChunkProxy(ChunkCoord);
+    }
+
+    ResetTileStore();
+
+    for (TArray<int32>& Free : FreeInstances)
+    {
+        Free.Empty();
+    }
+}
+
+FHexNoiseSettings AHexManager::GetNoiseSettings() const
+{
+    FHexNoiseSettings NoiseSettings;
+    NoiseSettings.NoiseType = NoiseType;
+    NoiseSettings.Seed = Seed;
+    NoiseSettings.Frequency = Frequency;
+    NoiseSettings.Interp = Interp;
+    NoiseSettings.FractalType = Fractaltype;
+    NoiseSettings.Octaves = Octaves;
+    NoiseSettings.Lacunarity = Lacunarity;
+    NoiseSettings.Gain = Gain;
+    NoiseSettings.CellularJitter = CellularJitter;
+    NoiseSettings.CellularDistanceFunction = CellularDistanceFunction;
+    NoiseSettings.CellularReturnType = CellularReturnType;
+    return NoiseSettings;
+}
+
+FHexGenerationInputs AHexManager::MakeGenerationInputs() const
+{
+    FHexGenerationInputs Inputs;
+    Inputs.Spacing = Settings->GetSpacing();
+    Inputs.HeightStrength = HeightStrength;
+    Inputs.GridWidth = GridWidth;
+    Inputs.GridHeight = GridHeight;
+    Inputs.ChunkSize = ChunkSize;
+    Inputs.bUnbounded = bUseChunkStreaming && bUnboundedGrid;
+
+    for (const FHexBiome& Biome : ActiveBiomes)
+    {
+        Inputs.BiomeThresholds.Add(Biome.GetThresholds());
+        Inputs.bSampleMoisture |= Biome.GetThresholds().UsesMoisture();
+    }
+
+    if (Inputs.bSampleMoisture)
+    {
+        Inputs.MoistureSettings = GetMoistureNoiseSettings();
+    }
+    return Inputs;
+}
+
+FHexNoiseSettings AHexManager::GetMoistureNoiseSettings() const
+{
+    FHexNoiseSettings NoiseSettings = GetNoiseSettings();
+    if (BiomeTable)
+    {
+        NoiseSettings.Seed += BiomeTable->MoistureSeedOffset;
+        NoiseSettings.Frequency = BiomeTable->MoistureFrequency;
+    }
+    return NoiseSettings;
+}
+
+bool AHexManager::SetupBiomes()
+{
+    ActiveBiomes.Reset();
+    ActiveTileBiomes.Reset();
+
+    if (BiomeTable)
+    {
+        ActiveBiomes.Append(BiomeTable->Biomes.GetData(), FMath::Min(BiomeTable->Biomes.Num(), MAX_uint8 + 1));
+    }
+    else
+    {
+        // The original two tile types, white so materials that ignore the custom data look unchanged
+        FHexBiome& Grass = ActiveBiomes.AddDefaulted_GetRef();
+        Grass.Name = TEXT("Grass");
+        Grass.TileType = EHexTileType::GRASS;
+        Grass.MinHeight = 0.f;
+        Grass.Mesh = GrassMesh;
+
+        FHexBiome& Water = ActiveBiomes.AddDefaulted_GetRef();
+        Water.Name = TEXT("Water");
+        Water.TileType = EHexTileType::WATER;
+        Water.MaxHeight = 0.f;
+        Water.Mesh = WaterMesh;
+        Water.Wetness = 1.f;
+    }
+
+    if (ActiveBiomes.IsEmpty()) return false;
+
+    // Biomes sharing a mesh share its HISM, the slot order follows the first biome using each mesh
+    TArray<UStaticMesh*> SlotMeshes;
+    BiomeLayoutHash = 0;
+    for (const FHexBiome& Biome : ActiveBiomes)
+    {
+        if (!Biome.Mesh) return false;
+
+        FHexTileBiome& TileBiome = ActiveTileBiomes.AddDefaulted_GetRef();
+        TileBiome.TileType = Biome.TileType;
+        TileBiome.MeshSlot = static_cast<uint8>(SlotMeshes.AddUnique(Biome.Mesh));
+
+        BiomeLayoutHash = HashCombineFast(BiomeLayoutHash, GetTypeHash(GetPathNameSafe(Biome.Mesh)));
+        BiomeLayoutHash = HashCombineFast(BiomeLayoutHash, GetTypeHash(Biome.TileType));
+        BiomeLayoutHash = HashCombineFast(BiomeLayoutHash, GetTypeHash(Biome.Colour));
+        BiomeLayoutHash = HashCombineFast(BiomeLayoutHash, GetTypeHash(Biome.Wetness));
+    }
+
+    for (int32 MeshSlot = 0; MeshSlot < SlotMeshes.Num(); ++MeshSlot)
+    {
+        UHierarchicalInstancedStaticMeshComponent* MeshComp = GetMeshComp(MeshSlot);
+        MeshComp->SetStaticMesh(SlotMeshes[MeshSlot]);
+        if (MeshComp->NumCustomDataFloats != HexBiomeCustomData::Num)
+        {
+            MeshComp->SetNumCustomDataFloats(HexBiomeCustomData::Num);
+        }
+    }
+
+    FreeInstances.SetNum(SlotMeshes.Num());
+    ApplyInstanceCollision();
+    return true;
+}
+
+UHierarchicalInstancedStaticMeshComponent* AHexManager::GetMeshComp(int32 MeshSlot)
+{
+    while (MeshComps.Num() <= MeshSlot)
+    {
+        UHierarchicalInstancedStaticMeshComponent* MeshComp = NewObject<UHierarchicalInstancedStaticMeshComponent>(
+            this, *FString::Printf(TEXT("BiomeMeshComp%d"), MeshComps.Num()));
+        MeshComp->SetupAttachment(RootComponent);
+        MeshComp->SetMobility(EComponentMobility::Movable);
+        MeshComp->bAutoRebuildTreeOnInstanceChanges = false;
+        MeshComp->RegisterComponent();
+
+        // Saved with the actor like the default components, baked levels keep its instances
+        AddInstanceComponent(MeshComp);
+        MeshComps.Add(MeshComp);
+    }
+
+    return MeshComps[MeshSlot];
+}
+
+void AHexManager::WriteInstanceCustomData(uint8 MeshSlot, int32 InstanceIndex, uint8 Biome, float Highlight, float Fog)
+{
+    float CustomData[HexBiomeCustomData::Num];
+    ActiveBiomes[Biome].GetCustomData(Highlight, Fog, CustomData);
+    MeshComps[MeshSlot]->SetCustomData(InstanceIndex, CustomData, false);
+}
+
+float AHexManager::GetInstanceHighlight(uint8 MeshSlot, int32 InstanceIndex) const
+{
+    const UHierarchicalInstancedStaticMeshComponent* MeshComp = MeshComps[MeshSlot];
+    const int32 DataIndex = InstanceIndex * MeshComp->NumCustomDataFloats + HexBiomeCustomData::Highlight;
+    return MeshComp->PerInstanceSMCustomData.IsValidIndex(DataIndex) ? MeshComp->PerInstanceSMCustomData[DataIndex] : 0.f;
+}
+
+void AHexManager::SetTileHighlight(FIntPoint TileCoord, float Highlight)
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    const int32 TileIndex = TileStore ? TileStore->FindTile(TileCoord) : INDEX_NONE;
+    if (TileIndex == INDEX_NONE) return;
+
+    const int32 InstanceIndex = TileStore->GetInstanceIndex(TileIndex);
+    if (InstanceIndex == INDEX_NONE) return;
+
+    MeshComps[TileStore->GetMeshSlot(TileIndex)]->SetCustomDataValue(InstanceIndex, HexBiomeCustomData::Highlight, Highlight, true);
+
+    if (PromotedTiles.Contains(TileCoord))
+    {
+        SyncPromotedTiles();
+    }
+}
+
+AHexTile* AHexManager::PromoteTile(FIntPoint TileCoord)
+{
+    if (AHexTile* const* Promoted = PromotedTiles.Find(TileCoord))
+        return *Promoted;
+
+    // Proxied chunks have no instances to swap out, the tile has to be drawn by the HISMs first
+    const FHexTileStore* TileStore = GetTileStore();
+    const int32 TileIndex = TileStore ? TileStore->FindTile(TileCoord) : INDEX_NONE;
+    if (TileIndex == INDEX_NONE || TileStore->GetInstanceIndex(TileIndex) == INDEX_NONE) return nullptr;
+
+    AHexTile* TileActor = nullptr;
+    while (!TileActor && FreeTileActors.Num() > 0)
+    {
+        TileActor = FreeTileActors.Pop(EAllowShrinking::No);
+        if (!IsValid(TileActor))
+            TileActor = nullptr;
+    }
+
+    if (!TileActor)
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.Owner = this;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+        TileActor = GetWorld()->SpawnActor<AHexTile>(PromotedTileClass ? *PromotedTileClass : AHexTile::StaticClass(),
+                                                     GetActorTransform(), SpawnParams);
+        if (!TileActor) return nullptr;
+    }
+
+    // Placed, dressed and its instance hidden by the sync, the same way edits to the tile reach it later
+    PromotedTiles.Add(TileCoord, TileActor);
+    FinishInstanceUpdates();
+
+    TileActor->ActivateTile();
+    return TileActor;
+}
+
+void AHexManager::DemoteTile(FIntPoint TileCoord)
+{
+    AHexTile* TileActor = nullptr;
+    if (!PromotedTiles.RemoveAndCopyValue(TileCoord, TileActor)) return;
+
+    const FHexTileStore* TileStore = GetTileStore();
+    const int32 TileIndex = TileStore ? TileStore->FindTile(TileCoord) : INDEX_NONE;
+    const int32 InstanceIndex = TileIndex != INDEX_NONE ? TileStore->GetInstanceIndex(TileIndex) : INDEX_NONE;
+    if (InstanceIndex != INDEX_NONE)
+    {
+        MeshComps[TileStore->GetMeshSlot(TileIndex)]->UpdateInstanceTransform(
+            InstanceIndex, FTransform(TileStore->GetTileLocalLocation(TileIndex)), false, false, true);
+    }
+
+    ReleaseTileActor(TileActor);
+    FinishInstanceUpdates();
+}
+
+AHexTile* AHexManager::FindPromotedTile(FIntPoint TileCoord) const
+{
+    AHexTile* const* TileActor = PromotedTiles.Find(TileCoord);
+    return TileActor ? *TileActor : nullptr;
+}
+
+void AHexManager::SyncPromotedTiles()
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    if (PromotedTiles.IsEmpty() || !TileStore) return;
+
+    const FTransform HiddenTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+    for (auto It = PromotedTiles.CreateIterator(); It; ++It)
+    {
+        AHexTile* TileActor = It.Value();
+        const int32 TileIndex = TileStore->FindTile(It.Key());
+        const int32 InstanceIndex = TileIndex != INDEX_NONE ? TileStore->GetInstanceIndex(TileIndex) : INDEX_NONE;
+
+        // Removed, unloaded or proxied, whatever happened to the instance the actor has nothing left to stand in for
+        if (!IsValid(TileActor) || InstanceIndex == INDEX_NONE)
+        {
+            ReleaseTileActor(TileActor);
+            It.RemoveCurrent();
+            continue;
+        }
+
+        // Edits and rebasing rewrite instance transforms, so the instance is hidden again every time
+        const uint8 MeshSlot = TileStore->GetMeshSlot(TileIndex);
+        MeshComps[MeshSlot]->UpdateInstanceTransform(InstanceIndex, HiddenTransform, false, false, true);
+
+        const uint8 Biome = TileStore->GetBiome(TileIndex);
+        float CustomData[HexBiomeCustomData::Num];
+        ActiveBiomes[Biome].GetCustomData(GetInstanceHighlight(MeshSlot, InstanceIndex), GetTileFog(It.Key()), CustomData);
+
+        TileActor->SetupTile(It.Key(), ActiveBiomes[Biome].TileType, ActiveBiomes[Biome].Mesh, CustomData);
+        TileActor->SetActorTransform(FTransform(TileStore->GetTileLocalLocation(TileIndex)) * GetActorTransform(),
+                                     false, nullptr, ETeleportType::TeleportPhysics);
+    }
+}
+
+void AHexManager::ReleaseTileActor(AHexTile* TileActor)
+{
+    if (!IsValid(TileActor)) return;
+
+    TileActor->DeactivateTile();
+    if (FreeTileActors.Num() < MaxPooledTileActors)
+    {
+        FreeTileActors.Add(TileActor);
+    }
+    else
+    {
+        TileActor->Destroy();
+    }
+}
+
+void AHexManager::UpdateFogOfWar()
+{
+    UWorld* World = GetWorld();
+    UHexGridSubsystem* Subsystem = World ? World->GetSubsystem<UHexGridSubsystem>() : nullptr;
+    const FHexTileStore* TileStore = GetTileStore();
+    if (!Subsystem || !TileStore) return;
+
+    FHexFogOfWar& FogOfWar = Subsystem->GetFogOfWar(this);
+
+    // Viewers are kept per controller, pawns only recompute what they see after stepping onto another tile
+    int32 RenderPlayerId = INDEX_NONE;
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        APlayerController* PlayerController = It->Get();
+        if (!PlayerController || !PlayerController->PlayerState) continue;
+
+        const int32 PlayerId = PlayerController->PlayerState->GetPlayerId();
+        if (RenderPlayerId == INDEX_NONE && PlayerController->IsLocalController())
+        {
+            RenderPlayerId = PlayerId;
+        }
+
+        const APawn* Pawn = PlayerController->GetPawn();
+        if (!Pawn) continue;
+
+        const int32* ViewerId = FogViewers.Find(PlayerController);
+        if (!ViewerId)
+        {
+            ViewerId = &FogViewers.Add(PlayerController, FogOfWar.AddViewer(PlayerId, FogSightRadius, FogEyeHeight));
+        }
+        FogOfWar.UpdateViewer(*ViewerId, *TileStore, Pawn->GetActorLocation());
+    }
+
+    // Players who left or lost their pawn stop seeing, what they explored stays explored
+    for (auto It = FogViewers.CreateIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It.Key().ResolveObjectPtr();
+        if (!PlayerController || !PlayerController->GetPawn())
+        {
+            FogOfWar.RemoveViewer(It.Value());
+            It.RemoveCurrent();
+        }
+    }
+
+    // Every loaded tile is rewritten once when the local player changes, afterwards only the changed ones
+    if (RenderPlayerId != FogRenderPlayerId)
+    {
+        FogRenderPlayerId = RenderPlayerId;
+
+        TArray<FIntPoint> LoadedChunks;
+        TileStore->GetChunkCoords(LoadedChunks);
+
+        TArray<FIntPoint> LoadedTiles;
+        for (const FIntPoint& ChunkCoord : LoadedChunks)
+        {
+            const int32 ChunkBase = TileStore->FindChunkBase(ChunkCoord);
+            for (int32 LocalIndex = 0; LocalIndex < TileStore->GetTilesPerChunk(); ++LocalIndex)
+            {
+                if (TileStore->IsValidTile(ChunkBase + LocalIndex))
+                {
+                    LoadedTiles.Add(TileStore->GetTileCoord(ChunkBase + LocalIndex));
+                }
+            }
+        }
+        WriteFogCustomData(LoadedTiles);
+    }
+
+    TArray<int32> PlayerIds;
+    FogOfWar.GetPlayerIds(PlayerIds);
+
+    TArray<FIntPoint> ChangedTiles;
+    for (const int32 PlayerId : PlayerIds)
+    {
+        ChangedTiles.Reset();
+        FogOfWar.ConsumeChangedTiles(PlayerId, ChangedTiles);
+        if (ChangedTiles.IsEmpty()) continue;
+
+        if (PlayerId == FogRenderPlayerId)
+        {
+            WriteFogCustomData(ChangedTiles);
+        }
+
+        OnHexFogChangedNative.Broadcast(PlayerId, ChangedTiles);
+        OnHexFogChanged.Broadcast(PlayerId, ChangedTiles);
+    }
+}
+
+float AHexManager::GetTileFog(const FIntPoint& TileCoord) const
+{
+    if (!bUseFogOfWar) return 1.f;
+
+    UWorld* World = GetWorld();
+    const UHexGridSubsystem* Subsystem = World ? World->GetSubsystem<UHexGridSubsystem>() : nullptr;
+    const FHexFogOfWar* FogOfWar = Subsystem ? Subsystem->FindFogOfWar(this) : nullptr;
+    if (!FogOfWar) return 0.f;
+
+    switch (FogOfWar->GetTileState(FogRenderPlayerId, TileCoord))
+    {
+    case EHexFogState::Visible:
+        return 1.f;
+    case EHexFogState::Explored:
+        return 0.5f;
+    default:
+        return 0.f;
+    }
+}
+
+void AHexManager::WriteFogCustomData(TConstArrayView<FIntPoint> TileCoords)
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    // Tiles of proxied chunks have no instance, they pick their fog up when the chunk is drawn as instances again
+    TBitArray<> DirtySlots(false, MeshComps.Num());
+    for (const FIntPoint& TileCoord : TileCoords)
+    {
+        const int32 TileIndex = TileStore->FindTile(TileCoord);
+        if (bUseMinimap && TileIndex != INDEX_NONE)
+        {
+            Minimap.SetTileColour(TileCoord, GetMinimapColour(*TileStore, TileIndex));
+        }
+
+        const int32 InstanceIndex = TileIndex != INDEX_NONE ? TileStore->GetInstanceIndex(TileIndex) : INDEX_NONE;
+        if (InstanceIndex == INDEX_NONE) continue;
+
+        const uint8 MeshSlot = TileStore->GetMeshSlot(TileIndex);
+        MeshComps[MeshSlot]->SetCustomDataValue(InstanceIndex, HexBiomeCustomData::Fog, GetTileFog(TileCoord), false);
+        DirtySlots[MeshSlot] = true;
+    }
+
+    for (TConstSetBitIterator<> It(DirtySlots); It; ++It)
+    {
+        MeshComps[It.GetIndex()]->MarkRenderStateDirty();
+    }
+}
+
+void AHexManager::UpdateInfluenceMaps()
+{
+    UWorld* World = GetWorld();
+    UHexGridSubsystem* Subsystem = World ? World->GetSubsystem<UHexGridSubsystem>() : nullptr;
+    const FHexTileStore* TileStore = GetTileStore();
+    if (!Subsystem || !TileStore) return;
+
+    FHexInfluenceMap& InfluenceMap = Subsystem->GetInfluenceMap(this);
+    InfluenceMap.FinishStep();
+    if (InfluenceMap.IsStepRunning()) return;
+
+    TArray<FVector> ViewerLocations;
+    GetViewerLocations(ViewerLocations);
+
+    if (!bUseChunkStreaming)
+    {
+        InfluenceMap.SetWindow(FIntPoint::ZeroValue, FIntPoint(GridWidth, GridHeight));
+    }
+    else
+    {
+        // Recentred once the player is a quarter window off centre, what both windows cover keeps its influence
+        const FIntPoint ViewerTile = TileStore->WorldToTileCoord(ViewerLocations[0]);
+        const FIntPoint Offset = ViewerTile - (InfluenceMap.GetMinTile() + InfluenceMap.GetSize() / 2);
+        if (InfluenceMap.GetSize() != InfluenceWindowSize
+            || FMath::Abs(Offset.X) > InfluenceWindowSize.X / 4 || FMath::Abs(Offset.Y) > InfluenceWindowSize.Y / 4)
+        {
+            InfluenceMap.SetWindow(ViewerTile - InfluenceWindowSize / 2, InfluenceWindowSize);
+        }
+    }
+
+    for (int32 Layer = 0; Layer < FHexInfluenceMap::NumLayers; ++Layer)
+    {
+        InfluenceMap.SetLayerSettings(static_cast<EHexInfluenceLayer>(Layer), InfluenceLayers[Layer]);
+    }
+
+    const FHexInfluenceLayerSettings& ThreatSettings = InfluenceLayers[static_cast<int32>(EHexInfluenceLayer::PlayerThreat)];
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (PlayerController && PlayerController->GetPawn())
+        {
+            InfluenceMap.AddSource(EHexInfluenceLayer::PlayerThreat, TileStore->WorldToTileCoord(PlayerController->GetPawn()->GetActorLocation()),
+                                   ThreatSettings.SourceStrength);
+        }
+    }
+
+    for (const AActor* Spawned : SpawnedActors)
+    {
+        if (!IsValid(Spawned)) continue;
+
+        for (int32 Layer = 0; Layer < FHexInfluenceMap::NumLayers; ++Layer)
+        {
+            const FHexInfluenceLayerSettings& LayerSettings = InfluenceLayers[Layer];
+            if (!LayerSettings.SourceTag.IsNone() && Spawned->ActorHasTag(LayerSettings.SourceTag))
+            {
+                InfluenceMap.AddSource(static_cast<EHexInfluenceLayer>(Layer), TileStore->WorldToTileCoord(Spawned->GetActorLocation()),
+                                       LayerSettings.SourceStrength);
+            }
+        }
+    }
+
+    InfluenceMap.LaunchStep(*TileStore);
+}
+
+void AHexManager::UpdateMinimap()
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    Minimap.FinishRaster(MinimapTexture);
+    if (Minimap.IsRasterRunning()) return;
+
+    FHexMinimapLayout Layout = Minimap.GetLayout();
+    Layout.Spacing = TileStore->GetSpacing();
+    Layout.PixelsPerTile = MinimapPixelsPerTile;
+
+    if (!bUseChunkStreaming)
+    {
+        Layout.MinTile = FIntPoint::ZeroValue;
+        Layout.NumTiles = FIntPoint(GridWidth, GridHeight);
+    }
+    else
+    {
+        // Recentred like the influence window, every tile is redrawn when it moves so it shouldn't move often
+        TArray<FVector> ViewerLocations;
+        GetViewerLocations(ViewerLocations);
+
+        const FIntPoint ViewerTile = TileStore->WorldToTileCoord(ViewerLocations[0]);
+        const FIntPoint Offset = ViewerTile - (Layout.MinTile + Layout.NumTiles / 2);
+        if (Layout.NumTiles != MinimapWindowSize
+            || FMath::Abs(Offset.X) > MinimapWindowSize.X / 4 || FMath::Abs(Offset.Y) > MinimapWindowSize.Y / 4)
+        {
+            Layout.MinTile = FHexTileStore::MakeAnchorTile(ViewerTile - MinimapWindowSize / 2);
+            Layout.NumTiles = MinimapWindowSize;
+        }
+    }
+
+    if (!(Layout == Minimap.GetLayout()))
+    {
+        Minimap.SetLayout(Layout);
+        MinimapChunkRevisions.Reset();
+
+        const FIntPoint TextureSize = Layout.GetTextureSize();
+        if (TextureSize.X <= 0 || TextureSize.Y <= 0) return;
+
+        if (!MinimapTexture || MinimapTexture->GetSizeX() != TextureSize.X || MinimapTexture->GetSizeY() != TextureSize.Y)
+        {
+            MinimapTexture = UTexture2D::CreateTransient(TextureSize.X, TextureSize.Y, PF_B8G8R8A8, TEXT("HexMinimap"));
+            MinimapTexture->Filter = TF_Nearest;
+            MinimapTexture->SRGB = true;
+            MinimapTexture->UpdateResource();
+        }
+    }
+
+    // Tiles are only recoloured for chunks whose revision moved, height and biome edits included
+    auto DrawChunk = [this, TileStore](const FIntPoint& ChunkCoord, int32 ChunkBase)
+    {
+        const FIntPoint FirstTile = ChunkCoord * TileStore->GetChunkSize();
+        for (int32 y = 0; y < TileStore->GetChunkSize(); ++y)
+        {
+            for (int32 x = 0; x < TileStore->GetChunkSize(); ++x)
+            {
+                const FIntPoint TileCoord = FirstTile + FIntPoint(x, y);
+                if (!Minimap.IsInWindow(TileCoord)) continue;
+
+                const int32 TileIndex = ChunkBase != INDEX_NONE ? ChunkBase + TileStore->GetLocalIndex(TileCoord) : INDEX_NONE;
+                const bool bValid = TileIndex != INDEX_NONE && TileStore->IsValidTile(TileIndex);
+                Minimap.SetTileColour(TileCoord, bValid ? GetMinimapColour(*TileStore, TileIndex) : FColor(0, 0, 0, 0));
+            }
+        }
+    };
+
+    for (auto It = MinimapChunkRevisions.CreateIterator(); It; ++It)
+    {
+        if (TileStore->FindChunkBase(It.Key()) == INDEX_NONE)
+        {
+            DrawChunk(It.Key(), INDEX_NONE);
+            It.RemoveCurrent();
+        }
+    }
+
+    const FHexMinimapLayout& Window = Minimap.GetLayout();
+    const FIntPoint MinChunk = TileStore->GetChunkCoord(Window.MinTile);
+    const FIntPoint MaxChunk = TileStore->GetChunkCoord(Window.MinTile + Window.NumTiles - FIntPoint(1, 1));
+
+    TArray<FIntPoint> LoadedChunks;
+    TileStore->GetChunkCoords(LoadedChunks);
+    for (const FIntPoint& ChunkCoord : LoadedChunks)
+    {
+        if (ChunkCoord.X < MinChunk.X || ChunkCoord.Y < MinChunk.Y || ChunkCoord.X > MaxChunk.X || ChunkCoord.Y > MaxChunk.Y) continue;
+
+        const uint32 Revision = TileStore->GetChunkRevision(ChunkCoord);
+        uint32& DrawnRevision = MinimapChunkRevisions.FindOrAdd(ChunkCoord, 0);
+        if (DrawnRevision == Revision) continue;
+
+        DrawnRevision = Revision;
+        DrawChunk(ChunkCoord, TileStore->FindChunkBase(ChunkCoord));
+    }
+
+    Minimap.LaunchRaster();
+}
+
+FColor AHexManager::GetMinimapColour(const FHexTileStore& TileStore, int32 TileIndex) const
+{
+    const uint8 Biome = TileStore.GetBiome(TileIndex);
+    if (!ActiveBiomes.IsValidIndex(Biome)) return FColor(0, 0, 0, 0);
+
+    // Higher ground reads lighter, explored tiles out of sight are dimmed and unexplored ones stay black
+    const float HeightAlpha = HeightStrength != 0.f ? TileStore.GetHeight(TileIndex) / FMath::Abs(HeightStrength) : 0.f;
+    const float Shade = FMath::GetMappedRangeValueClamped(FVector2f(-1.f, 1.f), FVector2f(0.6f, 1.2f), HeightAlpha);
+
+    FLinearColor Colour = ActiveBiomes[Biome].Colour * (Shade * GetTileFog(TileStore.GetTileCoord(TileIndex)));
+    Colour.A = 1.f;
+    return Colour.ToFColorSRGB();
+}
+
+void AHexManager::GenerateHexGrid()
+{
+    // Baked levels already hold the grid, the runtime call only has to announce it while the settings still match the bake
+    if (bBakedGridRestored)
+    {
+        if (BakedGrid.Key == MakeBakeKey())
+        {
+            BroadcastGridGenerated(BakedGrid.TileCoords.Num());
+            return;
+        }
+
+        bBakedGridRestored = false;
+    }
+
+    // Picked up by OnGenerationFinished once the running task has committed
+    if (bGenerationInFlight)
+    {
+        bFullGenerationPending = true;
+        return;
+    }
+
+    if (!SetupBiomes()) return;
+
+    // Rediff what is already loaded instead of clearing it, spawned actors survive on unchanged tiles
+    if (CanRegenerateIncrementally())
+    {
+        GetTileStore()->SetWorldLayout(GetActorLocation(), Settings->GetSpacing(), AnchorTile);
+
+        TArray<FIntPoint> ChunkCoords;
+        if (bUseChunkStreaming)
+        {
+            GetTileStore()->GetChunkCoords(ChunkCoords);
+        }
+        else
+        {
+            GetChunksInBounds(ChunkCoords);
+        }
+
+        LaunchGeneration(MoveTemp(ChunkCoords), EHexGenerationMode::Incremental);
+        return;
+    }
+
+    DestroyTiles();
+
+    if (bUseChunkStreaming)
+    {
+        StreamChunksAroundViewers(MAX_int32, true);
+        return;
+    }
+
+    TArray<FIntPoint> ChunkCoords;
+    GetChunksInBounds(ChunkCoords);
+    LaunchGeneration(MoveTemp(ChunkCoords), EHexGenerationMode::Full);
+}
+
+void AHexManager::GetChunksInBounds(TArray<FIntPoint>& OutChunkCoords) const
+{
+    const int32 NumChunksX = FMath::DivideAndRoundUp(GridWidth, ChunkSize);
+    const int32 NumChunksY = FMath::DivideAndRoundUp(GridHeight, ChunkSize);
+    for (int32 cy = 0; cy < NumChunksY; ++cy)
+    {
+        for (int32 cx = 0; cx < NumChunksX; ++cx)
+        {
+            OutChunkCoords.Add(FIntPoint(cx, cy));
+        }
+    }
+}
+
+void AHexManager::LaunchGeneration(TArray<FIntPoint>&& ChunkCoords, EHexGenerationMode Mode)
+{
+    if (ChunkCoords.IsEmpty()) return;
+
+    UHexGridSubsystem* Subsystem = GetWorld() ? GetWorld()->GetSubsystem<UHexGridSubsystem>() : nullptr;
+    if (!Subsystem) return;
+
+    const FHexGenerationInputs Inputs = MakeGenerationInputs();
+
+    // Shared with every other grid using the same settings, the task only ever reads them
+    TSharedRef<const FHexNoiseGenerator> HeightNoise = Subsystem->GetNoiseGenerator(GetNoiseSettings());
+    TSharedPtr<const FHexNoiseGenerator> MoistureNoise;
+    if (Inputs.bSampleMoisture)
+    {
+        MoistureNoise = Subsystem->GetNoiseGenerator(Inputs.MoistureSettings);
+    }
+
+    const uint64 CacheKey = FHexGridCache::MakeKey(GetNoiseSettings(), Inputs);
+    FString CachePath = bUseGridCache ? FHexGridCache::GetCachePath(CacheKey) : FString();
+
+    // Only a request covering every chunk in bounds can write the cache, streamed requests just read from it
+    const bool bCanWriteCache = bUseGridCache && Mode == EHexGenerationMode::Full && !bUseChunkStreaming;
+
+    bGenerationInFlight = true;
+
+    TWeakObjectPtr<AHexManager> WeakThis(this);
+    GenerationTask = UE::Tasks::Launch(UE_SOURCE_LOCATION,
+        [WeakThis, HeightNoise, MoistureNoise, Mode, Inputs, CacheKey, CachePath = MoveTemp(CachePath), bCanWriteCache,
+         ChunkCoords = MoveTemp(ChunkCoords)]()
+        {
+            TArray<FHexChunkBuffer> ChunkBuffers;
+            GenerateChunkBuffers(Inputs, *HeightNoise, MoistureNoise.Get(), CachePath, CacheKey, bCanWriteCache, ChunkCoords, ChunkBuffers);
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Mode, ChunkBuffers = MoveTemp(ChunkBuffers)]() mutable
+            {
+                if (AHexManager* HexManager = WeakThis.Get())
+                {
+                    HexManager->OnGenerationFinished(MoveTemp(ChunkBuffers), Mode);
+                }
+            });
+        });
+}
+
+void AHexManager::GenerateChunkBuffers(const FHexGenerationInputs& Inputs, const FHexNoiseGenerator& HeightNoise,
+                                       const FHexNoiseGenerator* MoistureNoise, const FString& CachePath, uint64 CacheKey,
+                                       bool bCanWriteCache, const TArray<FIntPoint>& ChunkCoords,
+                                       TArray<FHexChunkBuffer>& OutChunkBuffers)
+{
+    FHexGridCache Cache;
+    const bool bCacheHit = !CachePath.IsEmpty() && Cache.Open(CachePath, CacheKey);
+
+    OutChunkBuffers.SetNum(ChunkCoords.Num());
+
+    // Each worker samples its own copy of the generators, nothing written during sampling is shared
+    TArray<FHexGenerationNoise> WorkerNoise;
+    ParallelForWithTaskContext(WorkerNoise, ChunkCoords.Num(),
+        [&](int32 ContextIndex, int32 NumContexts) { return FHexGenerationNoise(HeightNoise, MoistureNoise); },
+        [&](FHexGenerationNoise& LocalNoise, int32 Index)
+        {
+            if (bCacheHit && Cache.ReadChunk(ChunkCoords[Index], OutChunkBuffers[Index])) return;
+
+            OutChunkBuffers[Index].ChunkCoord = ChunkCoords[Index];
+            BuildChunkTiles(Inputs, LocalNoise, OutChunkBuffers[Index]);
+        });
+
+    if (!bCacheHit && bCanWriteCache)
+    {
+        IFileManager::Get().MakeDirectory(*FPaths::GetPath(CachePath), true);
+        if (!FHexGridCache::Write(CachePath, CacheKey, Inputs.ChunkSize, OutChunkBuffers))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to write hex grid cache %s"), *CachePath);
+        }
+    }
+}
+
+void AHexManager::BuildChunkTiles(const FHexGenerationInputs& Inputs, const FHexGenerationNoise& Noise, FHexChunkBuffer& OutChunk)
+{
+    const int32 MinX = OutChunk.ChunkCoord.X * Inputs.ChunkSize;
+    const int32 MinY = OutChunk.ChunkCoord.Y * Inputs.ChunkSize;
+    const int32 MaxX = Inputs.bUnbounded ? MinX + Inputs.ChunkSize : FMath::Min(MinX + Inputs.ChunkSize, Inputs.GridWidth);
+    const int32 MaxY = Inputs.bUnbounded ? MinY + Inputs.ChunkSize : FMath::Min(MinY + Inputs.ChunkSize, Inputs.GridHeight);
+
+    const int32 NumTiles = FMath::Max(MaxX - MinX, 0) * FMath::Max(MaxY - MinY, 0);
+    if (NumTiles == 0) return;
+
+    OutChunk.TileCoords.Reserve(NumTiles);
+    OutChunk.LocalPositions.Reserve(NumTiles);
+    OutChunk.Biomes.Reserve(NumTiles);
+    OutChunk.Heights.SetNumUninitialized(NumTiles);
+
+    TArray<float> XPositions;
+    TArray<float> YPositions;
+    XPositions.Reserve(NumTiles);
+    YPositions.Reserve(NumTiles);
+
+    for (int32 y = MinY; y < MaxY; ++y)
+    {
+        for (int32 x = MinX; x < MaxX; ++x)
+        {
+            const FVector2f TilePos = FHexGridLayout::OffsetToWorld(FHexOffset(x, y), Inputs.Spacing);
+
+            OutChunk.TileCoords.Add(FIntPoint(x, y));
+            XPositions.Add(TilePos.X);
+            YPositions.Add(TilePos.Y);
+        }
+    }
+
+    Noise.Height.GetNoise2DBatch(XPositions, YPositions, OutChunk.Heights);
+
+    TArray<float> Moisture;
+    if (Noise.Moisture)
+    {
+        Moisture.SetNumUninitialized(NumTiles);
+        Noise.Moisture->GetNoise2DBatch(XPositions, YPositions, Moisture);
+    }
+
+    for (int32 i = 0; i < NumTiles; ++i)
+    {
+        const float NoiseValue = OutChunk.Heights[i];
+        OutChunk.LocalPositions.Add(FVector(XPositions[i], YPositions[i], NoiseValue * Inputs.HeightStrength));
+        OutChunk.Biomes.Add(UHexBiomeTable::Classify(Inputs.BiomeThresholds, NoiseValue, Noise.Moisture ? Moisture[i] : 0.f));
+    }
+}
+
+void AHexManager::OnGenerationFinished(TArray<FHexChunkBuffer>&& ChunkBuffers, EHexGenerationMode Mode)
+{
+    bGenerationInFlight = false;
+
+    // A newer full request supersedes whatever this task produced
+    if (bFullGenerationPending)
+    {
+        bFullGenerationPending = false;
+        GenerateHexGrid();
+        return;
+    }
+
+    if (Mode == EHexGenerationMode::Incremental)
+    {
+        CommitIncrementalRegeneration(ChunkBuffers);
+    }
+    else
+    {
+        CommitChunkBuffers(ChunkBuffers);
+    }
+
+    int32 NumTiles = 0;
+    for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
+    {
+        NumTiles += ChunkBuffer.TileCoords.Num();
+    }
+
+    BroadcastGridGenerated(NumTiles);
+
+    GetWorldTimerManager().ClearTimer(SpawnTimer);
+
+#if WITH_EDITOR
+    // Incremental regenerations reroll the preview too, they are what scrubbing the seed produces
+    if (ShouldPreviewSpawns())
+    {
+        UpdateSpawnPreview();
+        return;
+    }
+#endif
+
+    if (Mode == EHexGenerationMode::Full)
+    {
+        // Delay until navmesh is ready
+        SpawnTimer = GetWorldTimerManager().SetTimerForNextTick(this, &AHexManager::SpawnEnemiesAfterNavMeshReady);
+    }
+}
+
+void AHexManager::BroadcastGridGenerated(int32 NumTiles)
+{
+    if (OnHexGridGeneratedNative.IsBound())
+    {
+        OnHexGridGeneratedNative.Broadcast(NumTiles);
+    }
+
+    if (OnHexGridGenerated.IsBound())
+    {
+        OnHexGridGenerated.Broadcast(NumTiles);
+    }
+}
+
+void AHexManager::CommitChunkBuffers(const TArray<FHexChunkBuffer>& ChunkBuffers, TMap<int32, float>* OutHeightDeltas)
+{
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    const TConstArrayView<FHexTileBiome> TileBiomes = TileStore->GetBiomes();
+
+    FHexPendingInstances Pending;
+    auto PlaceTile = [this, &Pending](int32 TileIndex, const FVector& LocalPos, uint8 Biome)
+    {
+        PlaceTileInstance(Pending, TileIndex, LocalPos, Biome);
+    };
+
+    // Buffers only contribute the height, instances are placed relative to the anchor tile the grid has now
+    auto GetLocalPos = [TileStore](const FHexChunkBuffer& ChunkBuffer, int32 i)
+    {
+        return TileStore->GetLocalLocation(ChunkBuffer.TileCoords[i], ChunkBuffer.LocalPositions[i].Z);
+    };
+
+    for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
+    {
+        MarkCollisionDirty(ChunkBuffer.ChunkCoord);
+        InvalidateChunkProxy(ChunkBuffer.ChunkCoord);
+
+        if (!TileStore->HasChunk(ChunkBuffer.ChunkCoord))
+        {
+            const int32 ChunkBase = TileStore->AddChunk(ChunkBuffer.ChunkCoord);
+            for (int32 i = 0; i < ChunkBuffer.LocalPositions.Num(); ++i)
+            {
+                PlaceTile(ChunkBase + TileStore->GetLocalIndex(ChunkBuffer.TileCoords[i]), GetLocalPos(ChunkBuffer, i), ChunkBuffer.Biomes[i]);
+            }
+            continue;
+        }
+
+        if (!OutHeightDeltas) continue;
+
+        // Chunks the grid bounds no longer reach are dropped whole
+        if (ChunkBuffer.TileCoords.IsEmpty())
+        {
+            ReleaseChunk(ChunkBuffer.ChunkCoord);
+            continue;
+        }
+
+        const int32 ChunkBase = TileStore->FindChunkBase(ChunkBuffer.ChunkCoord);
+        TBitArray<> Regenerated(false, TileStore->GetTilesPerChunk());
+
+        for (int32 i = 0; i < ChunkBuffer.LocalPositions.Num(); ++i)
+        {
+            const FVector LocalPos = GetLocalPos(ChunkBuffer, i);
+            const uint8 Biome = ChunkBuffer.Biomes[i];
+            const int32 LocalIndex = TileStore->GetLocalIndex(ChunkBuffer.TileCoords[i]);
+            const int32 TileIndex = ChunkBase + LocalIndex;
+            Regenerated[LocalIndex] = true;
+
+            if (!TileStore->IsValidTile(TileIndex))
+            {
+                PlaceTile(TileIndex, LocalPos, Biome);
+                continue;
+            }
+
+            const float OldHeight = TileStore->GetHeight(TileIndex);
+            const uint8 OldBiome = TileStore->GetBiome(TileIndex);
+            const uint8 MeshSlot = TileStore->GetMeshSlot(TileIndex);
+            const int32 InstanceIndex = TileStore->GetInstanceIndex(TileIndex);
+            const bool bHeightChanged = !TileStore->IsSameHeight(TileIndex, LocalPos.Z);
+
+            if (TileBiomes[Biome].MeshSlot != MeshSlot)
+            {
+                // The tile moves to another HISM
+                ReleaseInstance(MeshSlot, InstanceIndex);
+                PlaceTile(TileIndex, LocalPos, Biome);
+            }
+            else if (OldBiome != Biome || bHeightChanged)
+            {
+                // Same mesh, only the transform and custom data of the instance change
+                if (bHeightChanged)
+                {
+                    MeshComps[MeshSlot]->UpdateInstanceTransform(InstanceIndex, FTransform(LocalPos), false, false, true);
+                    TileStore->SetHeight(TileIndex, LocalPos.Z);
+                }
+
+                if (OldBiome != Biome)
+                {
+                    WriteInstanceCustomData(MeshSlot, InstanceIndex, Biome, GetInstanceHighlight(MeshSlot, InstanceIndex),
+                                            GetTileFog(ChunkBuffer.TileCoords[i]));
+                    TileStore->SetBiome(TileIndex, Biome);
+                }
+            }
+            else
+            {
+                continue;
+            }
+
+            OutHeightDeltas->Add(TileIndex, TileStore->GetHeight(TileIndex) - OldHeight);
+        }
+
+        // Tiles a smaller grid no longer covers
+        for (int32 LocalIndex = 0; LocalIndex < TileStore->GetTilesPerChunk(); ++LocalIndex)
+        {
+            const int32 TileIndex = ChunkBase + LocalIndex;
+            if (Regenerated[LocalIndex] || !TileStore->IsValidTile(TileIndex)) continue;
+
+            ReleaseInstance(TileStore->GetMeshSlot(TileIndex), TileStore->GetInstanceIndex(TileIndex));
+            TileStore->RemoveTile(TileIndex);
+        }
+    }
+
+    AddPendingInstances(Pending);
+    FinishInstanceUpdates();
+}
+
+void AHexManager::PlaceTileInstance(FHexPendingInstances& Pending, int32 TileIndex, const FVector& LocalPos, uint8 Biome)
+{
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    // Reuse instances hidden by released chunks and edits before growing the HISMs
+    const uint8 MeshSlot = TileStore->GetBiomes()[Biome].MeshSlot;
+    TArray<int32>& Free = FreeInstances[MeshSlot];
+
+    int32 InstanceIndex = INDEX_NONE;
+    if (Free.Num() > 0)
+    {
+        InstanceIndex = Free.Pop(EAllowShrinking::No);
+        MeshComps[MeshSlot]->UpdateInstanceTransform(InstanceIndex, FTransform(LocalPos), false, false, true);
+        WriteInstanceCustomData(MeshSlot, InstanceIndex, Biome, 0.f, GetTileFog(TileStore->GetTileCoord(TileIndex)));
+    }
+    else
+    {
+        Pending.Transforms.SetNum(FMath::Max(Pending.Transforms.Num(), MeshSlot + 1));
+        Pending.Owners.SetNum(FMath::Max(Pending.Owners.Num(), MeshSlot + 1));
+        Pending.Transforms[MeshSlot].Add(FTransform(LocalPos));
+        Pending.Owners[MeshSlot].Add(TileIndex);
+    }
+
+    TileStore->SetTile(TileIndex, LocalPos.Z, Biome, InstanceIndex);
+}
+
+void AHexManager::AddPendingInstances(FHexPendingInstances& Pending)
+{
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    // One bulk add per HISM, owners learn their instance index once it returns
+    for (int32 MeshSlot = 0; MeshSlot < Pending.Transforms.Num(); ++MeshSlot)
+    {
+        if (Pending.Transforms[MeshSlot].IsEmpty()) continue;
+
+        const TArray<int32> Indices = MeshComps[MeshSlot]->AddInstances(Pending.Transforms[MeshSlot], true, false, false);
+        for (int32 i = 0; i < Indices.Num(); ++i)
+        {
+            const int32 TileIndex = Pending.Owners[MeshSlot][i];
+            TileStore->SetInstanceIndex(TileIndex, Indices[i]);
+            WriteInstanceCustomData(MeshSlot, Indices[i], TileStore->GetBiome(TileIndex), 0.f, GetTileFog(TileStore->GetTileCoord(TileIndex)));
+        }
+    }
+
+    Pending = FHexPendingInstances();
+}
+
+void AHexManager::CommitIncrementalRegeneration(const TArray<FHexChunkBuffer>& ChunkBuffers)
+{
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Tiles the spawned actors stand on, looked up before the diff can drop any of them
+    TArray<FIntPoint> ActorTileCoords;
+    TArray<int32> ActorTiles;
+    ActorTiles.Reserve(SpawnedActors.Num());
+    ActorTileCoords.Reserve(SpawnedActors.Num());
+    for (const AActor* Spawned : SpawnedActors)
+    {
+        const int32 TileIndex = IsValid(Spawned) ? TileStore->FindTileAtLocation(Spawned->GetActorLocation()) : INDEX_NONE;
+        ActorTiles.Add(TileIndex);
+        ActorTileCoords.Add(TileIndex != INDEX_NONE ? TileStore->GetTileCoord(TileIndex) : FIntPoint::NoneValue);
+    }
+
+    // Loaded chunks that weren't regenerated fall outside the new bounds
+    TSet<FIntPoint> RegeneratedChunks;
+    for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
+    {
+        RegeneratedChunks.Add(ChunkBuffer.ChunkCoord);
+    }
+
+    TArray<FIntPoint> LoadedChunks;
+    TileStore->GetChunkCoords(LoadedChunks);
+    for (const FIntPoint& ChunkCoord : LoadedChunks)
+    {
+        if (!RegeneratedChunks.Contains(ChunkCoord))
+        {
+            ReleaseChunk(ChunkCoord);
+        }
+    }
+
+    TMap<int32, float> HeightDeltas;
+    CommitChunkBuffers(ChunkBuffers, &HeightDeltas);
+
+    // Actors on removed tiles go, actors on changed tiles follow the new height, the rest are untouched
+    for (int32 i = SpawnedActors.Num() - 1; i >= 0; --i)
+    {
+        AActor* Spawned = SpawnedActors[i];
+        const int32 TileIndex = ActorTiles[i];
+        if (!IsValid(Spawned) || TileIndex == INDEX_NONE) continue;
+
+        if (!TileStore->IsValidTile(TileIndex) || TileStore->GetTileCoord(TileIndex) != ActorTileCoords[i])
+        {
+            Spawned->Destroy();
+            SpawnedActors.RemoveAtSwap(i);
+        }
+        else if (const float* HeightDelta = HeightDeltas.Find(TileIndex))
+        {
+            Spawned->AddActorWorldOffset(FVector(0.f, 0.f, *HeightDelta));
+        }
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("%s: incremental regeneration changed %d tiles in %.2f ms"),
+        *GetName(), HeightDeltas.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+bool AHexManager::CanRegenerateIncrementally() const
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    if (!bIncrementalRegeneration || !TileStore || TileStore->GetNumChunks() == 0) return false;
+
+    // Chunk pages, height quantization, tile placement and the biome meshes and looks all have to match what is loaded
+    const FHexSpacing Spacing = Settings->GetSpacing();
+    return CommittedBiomeLayoutHash == BiomeLayoutHash
+        && TileStore->GetChunkSize() == ChunkSize
+        && TileStore->GetHeightScale() == GetMaxTileHeight()
+        && TileStore->GetSpacing().Column == Spacing.Column
+        && TileStore->GetSpacing().Row == Spacing.Row;
+}
+
+void AHexManager::FinishInstanceUpdates()
+{
+    SyncPromotedTiles();
+
+    for (UHierarchicalInstancedStaticMeshComponent* MeshComp : MeshComps)
+    {
+        MeshComp->BuildTreeIfOutdated(true, false);
+        MeshComp->MarkRenderStateDirty();
+    }
+
+    UpdateChunkCollision();
+}
+
+FHexTileStore* AHexManager::GetTileStore() const
+{
+    UWorld* World = GetWorld();
+    UHexGridSubsystem* Subsystem = World ? World->GetSubsystem<UHexGridSubsystem>() : nullptr;
+    return Subsystem ? &Subsystem->GetTileStore(this) : nullptr;
+}
+
+void AHexManager::ResetTileStore()
+{
+    UWorld* World = GetWorld();
+    UHexGridSubsystem* Subsystem = World ? World->GetSubsystem<UHexGridSubsystem>() : nullptr;
+    if (!Subsystem) return;
+
+    ConfigureTileStore(Subsystem->GetTileStore(this));
+    CommittedBiomeLayoutHash = BiomeLayoutHash;
+
+    for (int32 MeshSlot = 0; MeshSlot < FreeInstances.Num(); ++MeshSlot)
+    {
+        Subsystem->RegisterInstanceComponent(this, MeshComps[MeshSlot], static_cast<uint8>(MeshSlot));
+    }
+}
+
+void AHexManager::ConfigureTileStore(FHexTileStore& TileStore) const
+{
+    TileStore.Reset(ChunkSize, GetMaxTileHeight(), ActiveTileBiomes);
+    TileStore.SetWorldLayout(GetActorLocation(), Settings->GetSpacing(), AnchorTile);
+
+    // Ground height queries read the tile tops from the store
+    TArray<FHexTileExtent> Extents;
+    GetTileExtents(Extents);
+    TArray<float> MeshSlotTops;
+    for (const FHexTileExtent& Extent : Extents)
+    {
+        MeshSlotTops.Add(Extent.Top);
+    }
+    TileStore.SetMeshSlotTops(MeshSlotTops);
+}
+
+FIntPoint AHexManager::GetChunkCoordAt(const FVector& WorldLocation) const
+{
+    const FVector LocalPos = WorldLocation - GetActorLocation();
+    const FIntPoint Tile = FHexGridLayout::WorldToOffsetPoint(LocalPos.X, LocalPos.Y, Settings->GetSpacing()) + AnchorTile;
+
+    return FIntPoint(
+        FMath::FloorToInt32(static_cast<double>(Tile.X) / ChunkSize),
+        FMath::FloorToInt32(static_cast<double>(Tile.Y) / ChunkSize));
+}
+
+void AHexManager::GetViewerLocations(TArray<FVector>& OutLocations) const
+{
+    UWorld* World = GetWorld();
+    if (!World) return;
+
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (PlayerController && PlayerController->GetPawn())
+        {
+            OutLocations.Add(PlayerController->GetPawn()->GetActorLocation());
+        }
+    }
+
+    // Editor worlds and the first generation before possession stream around the manager itself
+    if (OutLocations.IsEmpty())
+    {
+        OutLocations.Add(GetActorLocation());
+    }
+}
+
+void AHexManager::UpdateStreamedChunks()
+{
+    StreamChunksAroundViewers(MaxChunksLoadedPerUpdate, false);
+}
+
+void AHexManager::StreamChunksAroundViewers(int32 MaxChunksToLoad, bool bFullGrid)
+{
+    TArray<FVector> ViewerLocations;
+    GetViewerLocations(ViewerLocations);
+
+    const int32 NumChunksX = FMath::DivideAndRoundUp(GridWidth, ChunkSize);
+    const int32 NumChunksY = FMath::DivideAndRoundUp(GridHeight, ChunkSize);
+
+    TArray<FIntPoint> ViewerChunks;
+    for (const FVector& ViewerLocation : ViewerLocations)
+    {
+        ViewerChunks.AddUnique(GetChunkCoordAt(ViewerLocation));
+    }
+
+    auto DistanceToViewers = [&ViewerChunks](const FIntPoint& ChunkCoord)
+    {
+        int32 MinDistance = MAX_int32;
+        for (const FIntPoint& ViewerChunk : ViewerChunks)
+        {
+            const FIntPoint Delta = ChunkCoord - ViewerChunk;
+            MinDistance = FMath::Min(MinDistance, FMath::Max(FMath::Abs(Delta.X), FMath::Abs(Delta.Y)));
+        }
+        return MinDistance;
+    };
+
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    // Release with one chunk of hysteresis so players walking along a border don't thrash
+    TArray<FIntPoint> LoadedChunks;
+    TileStore->GetChunkCoords(LoadedChunks);
+
+    TArray<FIntPoint> ChunksToRelease;
+    for (const FIntPoint& ChunkCoord : LoadedChunks)
+    {
+        if (DistanceToViewers(ChunkCoord) > StreamingRadius + 1)
+        {
+            ChunksToRelease.Add(ChunkCoord);
+        }
+    }
+
+    for (const FIntPoint& ChunkCoord : ChunksToRelease)
+    {
+        ReleaseChunk(ChunkCoord);
+    }
+
+    if (ChunksToRelease.Num() > 0)
+    {
+        FinishInstanceUpdates();
+    }
+
+    TArray<FIntPoint> ChunksToLoad;
+    for (const FIntPoint& ViewerChunk : ViewerChunks)
+    {
+        for (int32 cy = ViewerChunk.Y - StreamingRadius; cy <= ViewerChunk.Y + StreamingRadius; ++cy)
+        {
+            for (int32 cx = ViewerChunk.X - StreamingRadius; cx <= ViewerChunk.X + StreamingRadius; ++cx)
+            {
+                const FIntPoint ChunkCoord(cx, cy);
+                if (!bUnboundedGrid && (cx < 0 || cy < 0 || cx >= NumChunksX || cy >= NumChunksY)) continue;
+                if (TileStore->HasChunk(ChunkCoord)) continue;
+
+                ChunksToLoad.AddUnique(ChunkCoord);
+            }
+        }
+    }
+
+    // Chunks still missing are picked up by the first update after the running task commits
+    if (ChunksToLoad.IsEmpty() || bGenerationInFlight) return;
+
+    if (!SetupBiomes()) return;
+
+    // Closest chunks first, the rest are picked up by the next updates
+    ChunksToLoad.Sort([&DistanceToViewers](const FIntPoint& A, const FIntPoint& B)
+    {
+        return DistanceToViewers(A) < DistanceToViewers(B);
+    });
+
+    if (ChunksToLoad.Num() > MaxChunksToLoad)
+    {
+        ChunksToLoad.SetNum(MaxChunksToLoad);
+    }
+
+    LaunchGeneration(MoveTemp(ChunksToLoad), bFullGrid ? EHexGenerationMode::Full : EHexGenerationMode::Stream);
+}
+
+void AHexManager::ReleaseChunk(const FIntPoint& ChunkCoord)
+{
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    const int32 ChunkBase = TileStore->FindChunkBase(ChunkCoord);
+    if (ChunkBase == INDEX_NONE) return;
+
+    // Tiles of a proxied chunk have no instances left to release
+    ReleaseChunkProxy(ChunkCoord);
+
+    for (int32 TileIndex = ChunkBase; TileIndex < ChunkBase + TileStore->GetTilesPerChunk(); ++TileIndex)
+    {
+        if (TileStore->IsValidTile(TileIndex))
+        {
+            ReleaseInstance(TileStore->GetMeshSlot(TileIndex), TileStore->GetInstanceIndex(TileIndex));
+        }
+    }
+
+    TileStore->RemoveChunk(ChunkCoord);
+    MarkCollisionDirty(ChunkCoord);
+}
+
+void AHexManager::ReleaseInstance(uint8 MeshSlot, int32 InstanceIndex)
+{
+    if (InstanceIndex == INDEX_NONE) return;
+
+    const FTransform HiddenTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+
+    MeshComps[MeshSlot]->UpdateInstanceTransform(InstanceIndex, HiddenTransform, false, false, true);
+    FreeInstances[MeshSlot].Add(InstanceIndex);
+}
+
+void AHexManager::RemoveTile(FIntPoint TileCoord)
+{
+    QueueTileEdit({ TileCoord, EHexTileEditType::Remove });
+}
+
+void AHexManager::SetTileHeight(FIntPoint TileCoord, float Height)
+{
+    QueueTileEdit({ TileCoord, EHexTileEditType::SetHeight, Height });
+}
+
+void AHexManager::RaiseTile(FIntPoint TileCoord, float Amount)
+{
+    QueueTileEdit({ TileCoord, EHexTileEditType::AddHeight, Amount });
+}
+
+void AHexManager::LowerTile(FIntPoint TileCoord, float Amount)
+{
+    QueueTileEdit({ TileCoord, EHexTileEditType::AddHeight, -Amount });
+}
+
+float AHexManager::GetMaxTileHeight() const
+{
+    return FMath::Max(FMath::Abs(HeightStrength), UE_KINDA_SMALL_NUMBER) * FMath::Max(TileEditHeightRange, 1.f);
+}
+
+void AHexManager::SetTileBiome(FIntPoint TileCoord, int32 Biome)
+{
+    if (!ActiveBiomes.IsValidIndex(Biome))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: no biome %d to retype tile (%d, %d) to"), *GetName(), Biome, TileCoord.X, TileCoord.Y);
+        return;
+    }
+
+    QueueTileEdit({ TileCoord, EHexTileEditType::SetBiome, 0.f, static_cast<uint8>(Biome) });
+}
+
+int32 AHexManager::FindBiome(FName BiomeName) const
+{
+    return ActiveBiomes.IndexOfByPredicate([BiomeName](const FHexBiome& Biome) { return Biome.Name == BiomeName; });
+}
+
+void AHexManager::QueueTileEdit(const FHexTileEdit& Edit)
+{
+    PendingTileEdits.Add(Edit);
+
+    if (!bTileEditsScheduled)
+    {
+        bTileEditsScheduled = true;
+        GetWorldTimerManager().SetTimerForNextTick(this, &AHexManager::ApplyTileEdits);
+    }
+}
+
+void AHexManager::ApplyTileEdits()
+{
+    bTileEditsScheduled = false;
+
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore || PendingTileEdits.IsEmpty()) return;
+
+    TArray<FHexTileEdit> Edits = MoveTemp(PendingTileEdits);
+    PendingTileEdits.Reset();
+
+    // Fold every edit of a tile into the state it ends the batch in, so each tile touches its instance once
+    TArray<FHexTileChange> Changes;
+    TArray<int32> ChangedTiles;
+    TMap<int32, int32> ChangeIndices;
+
+    for (const FHexTileEdit& Edit : Edits)
+    {
+        const int32 TileIndex = TileStore->FindTile(Edit.TileCoord);
+        if (TileIndex == INDEX_NONE) continue;
+
+        const int32* ChangeIndex = ChangeIndices.Find(TileIndex);
+        if (!ChangeIndex)
+        {
+            FHexTileChange& NewChange = Changes.AddDefaulted_GetRef();
+            NewChange.TileCoord = Edit.TileCoord;
+            NewChange.OldHeight = NewChange.NewHeight = TileStore->GetHeight(TileIndex);
+            NewChange.OldBiome = NewChange.NewBiome = TileStore->GetBiome(TileIndex);
+            ChangedTiles.Add(TileIndex);
+            ChangeIndex = &ChangeIndices.Add(TileIndex, Changes.Num() - 1);
+        }
+
+        FHexTileChange& Change = Changes[*ChangeIndex];
+        if (Change.bRemoved) continue;
+
+        switch (Edit.Type)
+        {
+        case EHexTileEditType::Remove:      Change.bRemoved = true; break;
+        case EHexTileEditType::SetHeight:   Change.NewHeight = Edit.Height; break;
+        case EHexTileEditType::AddHeight:   Change.NewHeight += Edit.Height; break;
+        case EHexTileEditType::SetBiome:    Change.NewBiome = Edit.Biome; break;
+        }
+    }
+
+    FHexPendingInstances Pending;
+    for (int32 i = 0; i < Changes.Num(); ++i)
+    {
+        FHexTileChange& Change = Changes[i];
+        const int32 TileIndex = ChangedTiles[i];
+        const FIntPoint ChunkCoord = TileStore->GetChunkCoord(Change.TileCoord);
+        MarkCollisionDirty(ChunkCoord);
+        InvalidateChunkProxy(ChunkCoord);
+
+        const uint8 MeshSlot = TileStore->GetMeshSlot(TileIndex);
+        const int32 InstanceIndex = TileStore->GetInstanceIndex(TileIndex);
+
+        if (Change.bRemoved)
+        {
+            ReleaseInstance(MeshSlot, InstanceIndex);
+            TileStore->RemoveTile(TileIndex);
+            continue;
+        }
+
+        // The store would clamp the height, dropping the edit says so instead of leaving the tile somewhere else
+        if (FMath::Abs(Change.NewHeight) > TileStore->GetHeightScale())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s: height %f of tile (%d, %d) is beyond the grid's %f, increase TileEditHeightRange"),
+                   *GetName(), Change.NewHeight, Change.TileCoord.X, Change.TileCoord.Y, TileStore->GetHeightScale());
+            Change.NewHeight = Change.OldHeight;
+        }
+
+        const bool bHeightChanged = !TileStore->IsSameHeight(TileIndex, Change.NewHeight);
+        const bool bBiomeChanged = Change.NewBiome != Change.OldBiome && TileStore->GetBiomes().IsValidIndex(Change.NewBiome);
+
+        if (bBiomeChanged && TileStore->GetBiomes()[Change.NewBiome].MeshSlot != MeshSlot)
+        {
+            // The tile moves to another HISM
+            FVector LocalPos = TileStore->GetTileLocalLocation(TileIndex);
+            LocalPos.Z = Change.NewHeight;
+            ReleaseInstance(MeshSlot, InstanceIndex);
+            PlaceTileInstance(Pending, TileIndex, LocalPos, Change.NewBiome);
+        }
+        else
+        {
+            if (bHeightChanged)
+            {
+                TileStore->SetHeight(TileIndex, Change.NewHeight);
+                MeshComps[MeshSlot]->UpdateInstanceTransform(
+                    InstanceIndex, FTransform(TileStore->GetTileLocalLocation(TileIndex)), false, false, true);
+            }
+
+            if (bBiomeChanged)
+            {
+                WriteInstanceCustomData(MeshSlot, InstanceIndex, Change.NewBiome, GetInstanceHighlight(MeshSlot, InstanceIndex),
+                                        GetTileFog(Change.TileCoord));
+                TileStore->SetBiome(TileIndex, Change.NewBiome);
+            }
+        }
+
+        // Report what the store ended up with, heights are quantized to int16 steps of the edit range
+        Change.NewHeight = TileStore->GetHeight(TileIndex);
+        Change.NewBiome = TileStore->GetBiome(TileIndex);
+    }
+
+    AddPendingInstances(Pending);
+    FinishInstanceUpdates();
+
+    // Edits that cancelled out or changed nothing aren't reported
+    Changes.RemoveAll([](const FHexTileChange& Change)
+    {
+        return !Change.bRemoved && Change.NewHeight == Change.OldHeight && Change.NewBiome == Change.OldBiome;
+    });
+
+    if (Changes.Num() > 0)
+    {
+        BroadcastTilesChanged(Changes);
+    }
+}
+
+void AHexManager::BroadcastTilesChanged(const TArray<FHexTileChange>& Changes)
+{
+    if (OnHexTilesChangedNative.IsBound())
+    {
+        OnHexTilesChangedNative.Broadcast(Changes);
+    }
+
+    if (OnHexTilesChanged.IsBound())
+    {
+        OnHexTilesChanged.Broadcast(Changes);
+    }
+}
+
+void AHexManager::ApplyInstanceCollision()
+{
+    const ECollisionEnabled::Type InstanceCollision = CollisionMode == EHexCollisionMode::PerInstance
+        ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision;
+
+    for (UHierarchicalInstancedStaticMeshComponent* MeshComp : MeshComps)
+    {
+        MeshComp->SetCollisionEnabled(InstanceCollision);
+    }
+}
+
+void AHexManager::SetCollisionMode(EHexCollisionMode InCollisionMode)
+{
+    CollisionMode = InCollisionMode;
+    ApplyInstanceCollision();
+
+    if (const FHexTileStore* TileStore = GetTileStore())
+    {
+        TArray<FIntPoint> LoadedChunks;
+        TileStore->GetChunkCoords(LoadedChunks);
+        DirtyCollisionChunks.Append(LoadedChunks);
+    }
+
+    UpdateChunkCollision();
+}
+
+bool AHexManager::NeedsChunkCollision(const FIntPoint& ChunkCoord) const
+{
+    // Proxied chunks have no instances, so no instance bodies either
+    return CollisionMode != EHexCollisionMode::PerInstance || IsChunkProxied(ChunkCoord);
+}
+
+void AHexManager::MarkCollisionDirty(const FIntPoint& ChunkCoord)
+{
+    if (NeedsChunkCollision(ChunkCoord) || ChunkCollision.Contains(ChunkCoord))
+    {
+        DirtyCollisionChunks.Add(ChunkCoord);
+    }
+}
+
+void AHexManager::GetTileExtents(TArray<FHexTileExtent>& OutExtents) const
+{
+    // Instances sit at the tile height, the mesh bounds tell how far each slot's hex reaches above and below it
+    for (const UHierarchicalInstancedStaticMeshComponent* MeshComp : MeshComps)
+    {
+        FHexTileExtent& Extent = OutExtents.AddDefaulted_GetRef();
+        if (const UStaticMesh* Mesh = MeshComp->GetStaticMesh())
+        {
+            Extent.Top = Mesh->GetBoundingBox().Max.Z;
+            Extent.Bottom = Mesh->GetBoundingBox().Min.Z;
+        }
+    }
+}
+
+void AHexManager::UpdateChunkCollision()
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore || DirtyCollisionChunks.IsEmpty()) return;
+
+    TArray<FHexTileExtent> Extents;
+    GetTileExtents(Extents);
+
+    // Proxied chunks fall back to the merged tri mesh while the grid otherwise uses instance bodies
+    const EHexCollisionMode ChunkMode = CollisionMode == EHexCollisionMode::PerInstance ? EHexCollisionMode::ChunkTriMesh : CollisionMode;
+    const UHierarchicalInstancedStaticMeshComponent* ResponseSource = MeshComps[0];
+
+    FHexChunkTiles Tiles;
+    for (const FIntPoint& ChunkCoord : DirtyCollisionChunks)
+    {
+        if (!NeedsChunkCollision(ChunkCoord) || !Tiles.Read(*TileStore, ChunkCoord))
+        {
+            ReleaseChunkCollision(ChunkCoord);
+            continue;
+        }
+
+        UHexChunkCollisionComponent*& ChunkComp = ChunkCollision.FindOrAdd(ChunkCoord);
+        if (!ChunkComp)
+        {
+            if (FreeChunkCollision.Num() > 0)
+            {
+                ChunkComp = FreeChunkCollision.Pop(EAllowShrinking::No);
+            }
+            else
+            {
+                ChunkComp = NewObject<UHexChunkCollisionComponent>(this, NAME_None, RF_Transient);
+                ChunkComp->SetupAttachment(RootComponent);
+                ChunkComp->RegisterComponent();
+            }
+
+            // Blocks whatever the tiles blocked before their own collision was turned off
+            ChunkComp->SetCollisionObjectType(ResponseSource->GetCollisionObjectType());
+            ChunkComp->SetCollisionResponseToChannels(ResponseSource->GetCollisionResponseToChannels());
+        }
+
+        ChunkComp->Build(Tiles, Extents, ChunkMode);
+        ChunkComp->SetRelativeLocation(TileStore->GetChunkLocalOrigin(ChunkCoord));
+    }
+
+    DirtyCollisionChunks.Reset();
+}
+
+void AHexManager::ReleaseChunkCollision(const FIntPoint& ChunkCoord)
+{
+    UHexChunkCollisionComponent* ChunkComp = nullptr;
+    if (!ChunkCollision.RemoveAndCopyValue(ChunkCoord, ChunkComp) || !ChunkComp) return;
+
+    ChunkComp->ClearCollision();
+    FreeChunkCollision.Add(ChunkComp);
+}
+
+void AHexManager::BenchmarkCollision()
+{
+    RunCollisionBenchmarkStep(0, CollisionMode);
+}
+
+void AHexManager::RunCollisionBenchmarkStep(int32 Step, EHexCollisionMode RestoreMode)
+{
+    static constexpr EHexCollisionMode Modes[] =
+    {
+        EHexCollisionMode::PerInstance, EHexCollisionMode::ChunkTriMesh, EHexCollisionMode::ChunkConvex,
+    };
+
+    // Each mode is measured a moment after switching to it, once the physics scene has taken in the new bodies
+    if (Step > 0)
+    {
+        LogCollisionCost();
+    }
+
+    if (Step == UE_ARRAY_COUNT(Modes))
+    {
+        SetCollisionMode(RestoreMode);
+        return;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+    SetCollisionMode(Modes[Step]);
+    UE_LOG(LogTemp, Display, TEXT("%s: building %s collision took %.2f ms"),
+        *GetName(), *UEnum::GetValueAsString(Modes[Step]), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    FTimerHandle StepHandle;
+    GetWorldTimerManager().SetTimer(StepHandle,
+        FTimerDelegate::CreateUObject(this, &AHexManager::RunCollisionBenchmarkStep, Step + 1, RestoreMode), 0.5f, false);
+}
+
+void AHexManager::LogCollisionCost()
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    UWorld* World = GetWorld();
+    if (!TileStore || !World) return;
+
+    // Physics side only, the render data of the HISMs is the same in every mode
+    FResourceSizeEx PhysicsSize(EResourceSizeMode::Exclusive);
+    int32 NumBodies = 0;
+    int32 NumShapes = 0;
+
+    for (UHierarchicalInstancedStaticMeshComponent* MeshComp : MeshComps)
+    {
+        UBodySetup* MeshBodySetup = MeshComp->GetBodySetup();
+        const int32 ShapesPerBody = MeshBodySetup ? FMath::Max(MeshBodySetup->AggGeom.GetElementCount(), 1) : 1;
+
+        int32 NumMeshBodies = 0;
+        for (const FBodyInstance* Body : MeshComp->InstanceBodies)
+        {
+            if (!Body || !Body->IsValidBodyInstance()) continue;
+
+            Body->GetBodyInstanceResourceSizeEx(PhysicsSize);
+            PhysicsSize.AddDedicatedSystemMemoryBytes(sizeof(FBodyInstance));
+            ++NumMeshBodies;
+        }
+
+        // The cooked mesh collision is shared by every instance, count it once
+        if (NumMeshBodies > 0 && MeshBodySetup)
+        {
+            MeshBodySetup->GetResourceSizeEx(PhysicsSize);
+        }
+
+        NumBodies += NumMeshBodies;
+        NumShapes += NumMeshBodies * ShapesPerBody;
+    }
+
+    for (const TPair<FIntPoint, UHexChunkCollisionComponent*>& Pair : ChunkCollision)
+    {
+        UHexChunkCollisionComponent* ChunkComp = Pair.Value;
+        if (!ChunkComp->BodyInstance.IsValidBodyInstance()) continue;
+
+        ChunkComp->BodyInstance.GetBodyInstanceResourceSizeEx(PhysicsSize);
+        ChunkComp->GetBodySetup()->GetResourceSizeEx(PhysicsSize);
+        ++NumBodies;
+        NumShapes += ChunkComp->GetNumShapes();
+    }
+
+    TArray<FVector> TileLocations;
+    TileStore->ForEachTile([TileStore, &TileLocations](int32 TileIndex, const FIntPoint& TileCoord)
+    {
+        TileLocations.Add(TileStore->GetTileLocation(TileIndex));
+    });
+
+    if (TileLocations.IsEmpty()) return;
+
+    // Floor checks the size of a walking character's, from above a random tile down past it. Same tiles in every mode
+    constexpr int32 NumSweeps = 10000;
+    const FCollisionShape Capsule = FCollisionShape::MakeCapsule(34.f, 88.f);
+    const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HexCollisionBenchmark), false);
+    FRandomStream Random(NumSweeps);
+
+    int32 NumHits = 0;
+    const double StartTime = FPlatformTime::Seconds();
+    for (int32 i = 0; i < NumSweeps; ++i)
+    {
+        const FVector& TileLocation = TileLocations[Random.RandHelper(TileLocations.Num())];
+        FHitResult Hit;
+        if (World->SweepSingleByChannel(Hit, TileLocation + FVector(0.f, 0.f, 300.f), TileLocation - FVector(0.f, 0.f, 300.f),
+                                        FQuat::Identity, ECC_Pawn, Capsule, QueryParams))
+        {
+            ++NumHits;
+        }
+    }
+    const double SweepMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1000000.0 / NumSweeps;
+
+    UE_LOG(LogTemp, Display, TEXT("%s: %s collision, %d tiles: %d bodies, %d shapes, %.1f KB physics memory, floor sweep %.2f us (%d/%d hit)"),
+        *GetName(), *UEnum::GetValueAsString(CollisionMode), TileLocations.Num(), NumBodies, NumShapes,
+        PhysicsSize.GetTotalMemoryBytes() / 1024.0, SweepMicroseconds, NumHits, NumSweeps);
+}
+
+bool AHexManager::IsChunkProxied(const FIntPoint& ChunkCoord) const
+{
+    const FHexChunkProxy* Proxy = ChunkProxies.Find(ChunkCoord);
+    return Proxy && Proxy->bActive;
+}
+
+void AHexManager::GetCameraLocations(TArray<FVector>& OutLocations) const
+{
+    UWorld* World = GetWorld();
+    if (!World) return;
+
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (PlayerController && PlayerController->PlayerCameraManager)
+        {
+            OutLocations.Add(PlayerController->PlayerCameraManager->GetCameraLocation());
+        }
+    }
+
+    if (OutLocations.IsEmpty())
+    {
+        GetViewerLocations(OutLocations);
+    }
+}
+
+void AHexManager::UpdateChunkProxies()
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    TArray<FVector> CameraLocations;
+    GetCameraLocations(CameraLocations);
+
+    TArray<FIntPoint> LoadedChunks;
+    TileStore->GetChunkCoords(LoadedChunks);
+
+    const FIntPoint HalfChunk(TileStore->GetChunkSize() / 2, TileStore->GetChunkSize() / 2);
+
+    FHexPendingInstances Pending;
+    bool bInstancesChanged = false;
+    int32 NumBuildsLaunched = 0;
+
+    for (const FIntPoint& ChunkCoord : LoadedChunks)
+    {
+        const FVector ChunkLocation = GetActorLocation() + TileStore->GetLocalLocation(ChunkCoord * TileStore->GetChunkSize() + HalfChunk);
+
+        float Distance = MAX_flt;
+        for (const FVector& CameraLocation : CameraLocations)
+        {
+            Distance = FMath::Min(Distance, static_cast<float>(FVector::Dist2D(CameraLocation, ChunkLocation)));
+        }
+
+        FHexChunkProxy* Proxy = ChunkProxies.Find(ChunkCoord);
+        const bool bActive = Proxy && Proxy->bActive;
+        const bool bWantsProxy = Distance > (bActive ? ProxyDistance - ProxyHysteresis : ProxyDistance);
+
+        if (!bWantsProxy)
+        {
+            if (bActive)
+            {
+                DeactivateChunkProxy(ChunkCoord, Pending);
+                bInstancesChanged = true;
+            }
+            continue;
+        }
+
+        if (bActive) continue;
+
+        if (!Proxy)
+        {
+            Proxy = &ChunkProxies.Add(ChunkCoord);
+            Proxy->Version = ++LastProxyVersion;
+        }
+
+        if (Proxy->Component && Proxy->BuiltVersion == Proxy->Version)
+        {
+            ActivateChunkProxy(ChunkCoord);
+            bInstancesChanged = true;
+        }
+        else if (!Proxy->bBuilding && NumBuildsLaunched < MaxProxyBuildsPerUpdate)
+        {
+            LaunchProxyBuild(ChunkCoord);
+            ++NumBuildsLaunched;
+        }
+    }
+
+    if (bInstancesChanged)
+    {
+        AddPendingInstances(Pending);
+        FinishInstanceUpdates();
+    }
+}
+
+void AHexManager::LaunchProxyBuild(const FIntPoint& ChunkCoord)
+{
+    const FHexTileStore* TileStore = GetTileStore();
+    FHexChunkProxy* Proxy = ChunkProxies.Find(ChunkCoord);
+    if (!TileStore || !Proxy) return;
 
-    RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComp"));
+    // Everything the worker reads is copied here, the store can change under it
+    FHexChunkTiles Tiles;
+    if (!Tiles.Read(*TileStore, ChunkCoord)) return;
 
-    GrassMeshComp = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("GrassMeshComp"));
-    GrassMeshComp->SetupAttachment(RootComponent);
+    TArray<FHexTileExtent> Extents;
+    GetTileExtents(Extents);
 
-    WaterMeshComp = CreateDefaultSubobject<UHierarchicalInstancedStaticMeshComponent>(TEXT("WaterMeshComp"));
-    WaterMeshComp->SetupAttachment(RootComponent);
+    TArray<FLinearColor> BiomeColours;
+    for (const FHexBiome& Biome : ActiveBiomes)
+    {
+        BiomeColours.Add(Biome.Colour);
+    }
 
-    GrassMeshComp->SetMobility(EComponentMobility::Movable);
-    WaterMeshComp->SetMobility(EComponentMobility::Movable);
+    Proxy->bBuilding = true;
 
-    Settings = GetMutableDefault<UHexGridSettings>();
-    check(Settings);
+    TWeakObjectPtr<AHexManager> WeakThis(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION,
+        [WeakThis, ChunkCoord, Version = Proxy->Version, Tiles = MoveTemp(Tiles), Extents = MoveTemp(Extents),
+         BiomeColours = MoveTemp(BiomeColours)]()
+        {
+            FHexChunkSurface Surface;
+            Surface.Build(Tiles, Extents);
+
+            FMeshDescription MeshDescription;
+            Surface.ToMeshDescription(BiomeColours, MeshDescription);
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, ChunkCoord, Version, MeshDescription = MoveTemp(MeshDescription)]() mutable
+            {
+                if (AHexManager* HexManager = WeakThis.Get())
+                {
+                    HexManager->OnProxyBuilt(ChunkCoord, Version, MoveTemp(MeshDescription));
+                }
+            });
+        });
 }
 
-void AHexManager::BeginPlay()
+void AHexManager::OnProxyBuilt(const FIntPoint& ChunkCoord, uint32 Version, FMeshDescription&& MeshDescription)
 {
-    Super::BeginPlay();
+    FHexChunkProxy* Proxy = ChunkProxies.Find(ChunkCoord);
+    if (!Proxy || Proxy->Version != Version)
+    {
+        // Released or changed while building, the next update starts over from the current tiles
+        if (Proxy)
+        {
+            Proxy->bBuilding = false;
+        }
+        return;
+    }
+
+    Proxy->bBuilding = false;
+
+    UMaterialInterface* Material = ProxyMaterial ? ProxyMaterial : MeshComps[0]->GetMaterial(0);
+
+    UStaticMesh* ProxyMesh = NewObject<UStaticMesh>(this, NAME_None, RF_Transient);
+    ProxyMesh->GetStaticMaterials().Add(FStaticMaterial(Material, FHexChunkSurface::ProxyMaterialSlot));
+
+    UStaticMesh::FBuildMeshDescriptionsParams BuildParams;
+    BuildParams.bFastBuild = true;
+    BuildParams.bBuildSimpleCollision = false;
+    BuildParams.bCommitMeshDescription = false;
+    BuildParams.bMarkPackageDirty = false;
+    ProxyMesh->BuildFromMeshDescriptions({ &MeshDescription }, BuildParams);
+
+    if (!Proxy->Component)
+    {
+        if (FreeProxyComponents.Num() > 0)
+        {
+            Proxy->Component = FreeProxyComponents.Pop(EAllowShrinking::No);
+        }
+        else
+        {
+            Proxy->Component = NewObject<UStaticMeshComponent>(this, NAME_None, RF_Transient);
+            Proxy->Component->SetupAttachment(RootComponent);
+            Proxy->Component->SetMobility(EComponentMobility::Movable);
+            Proxy->Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+            Proxy->Component->SetCanEverAffectNavigation(false);
+            Proxy->Component->SetVisibility(false);
+            Proxy->Component->RegisterComponent();
+        }
+    }
+
+    Proxy->Component->SetStaticMesh(ProxyMesh);
+    Proxy->Component->SetRelativeLocation(GetTileStore()->GetChunkLocalOrigin(ChunkCoord));
+    Proxy->BuiltVersion = Version;
+
+    ActivateChunkProxy(ChunkCoord);
+    FinishInstanceUpdates();
 }
 
-void AHexManager::DestroyTiles()
+void AHexManager::ActivateChunkProxy(const FIntPoint& ChunkCoord)
 {
-    if (!IsValid(GrassMeshComp) || !IsValid(WaterMeshComp))
-        return;
+    FHexTileStore* TileStore = GetTileStore();
+    FHexChunkProxy* Proxy = ChunkProxies.Find(ChunkCoord);
+    const int32 ChunkBase = TileStore ? TileStore->FindChunkBase(ChunkCoord) : INDEX_NONE;
+    if (!Proxy || !Proxy->Component || ChunkBase == INDEX_NONE) return;
+
+    for (int32 TileIndex = ChunkBase; TileIndex < ChunkBase + TileStore->GetTilesPerChunk(); ++TileIndex)
+    {
+        if (!TileStore->IsValidTile(TileIndex)) continue;
 
-    GrassMeshComp->ClearInstances();
-    WaterMeshComp->ClearInstances();
+        ReleaseInstance(TileStore->GetMeshSlot(TileIndex), TileStore->GetInstanceIndex(TileIndex));
+        TileStore->SetInstanceIndex(TileIndex, INDEX_NONE);
+    }
 
-    for (AActor* Spawned : SpawnedActors)
+    Proxy->Component->SetVisibility(true);
+    Proxy->bActive = true;
+    MarkCollisionDirty(ChunkCoord);
+}
+
+void AHexManager::DeactivateChunkProxy(const FIntPoint& ChunkCoord, FHexPendingInstances& Pending)
+{
+    FHexTileStore* TileStore = GetTileStore();
+    FHexChunkProxy* Proxy = ChunkProxies.Find(ChunkCoord);
+    const int32 ChunkBase = TileStore ? TileStore->FindChunkBase(ChunkCoord) : INDEX_NONE;
+    if (!Proxy || !Proxy->bActive || ChunkBase == INDEX_NONE) return;
+
+    for (int32 TileIndex = ChunkBase; TileIndex < ChunkBase + TileStore->GetTilesPerChunk(); ++TileIndex)
     {
-        if (IsValid(Spawned))
-            Spawned->Destroy();
+        if (TileStore->IsValidTile(TileIndex))
+        {
+            PlaceTileInstance(Pending, TileIndex, TileStore->GetTileLocalLocation(TileIndex), TileStore->GetBiome(TileIndex));
+        }
     }
 
-    SpawnedActors.Empty();
-    TilePositions.Empty();
+    Proxy->Component->SetVisibility(false);
+    Proxy->bActive = false;
+    MarkCollisionDirty(ChunkCoord);
 }
 
-void AHexManager::GenerateHexGrid()
+void AHexManager::InvalidateChunkProxy(const FIntPoint& ChunkCoord)
+{
+    FHexChunkProxy* Proxy = ChunkProxies.Find(ChunkCoord);
+    if (!Proxy) return;
+
+    Proxy->Version = ++LastProxyVersion;
+
+    // Edits and diffs work on instances, so the chunk gets them back before anything touches its tiles
+    if (Proxy->bActive)
+    {
+        FHexPendingInstances Pending;
+        DeactivateChunkProxy(ChunkCoord, Pending);
+        AddPendingInstances(Pending);
+    }
+}
+
+void AHexManager::ReleaseChunkProxy(const FIntPoint& ChunkCoord)
+{
+    FHexChunkProxy Proxy;
+    if (!ChunkProxies.RemoveAndCopyValue(ChunkCoord, Proxy) || !Proxy.Component) return;
+
+    Proxy.Component->SetVisibility(false);
+    Proxy.Component->SetStaticMesh(nullptr);
+    FreeProxyComponents.Add(Proxy.Component);
+}
+
+void AHexManager::ApplyWorldOffset(const FVector& InOffset, bool bWorldShift)
+{
+    Super::ApplyWorldOffset(InOffset, bWorldShift);
+
+    // The components moved with the actor, the store only has to learn where the anchor tile went
+    if (FHexTileStore* TileStore = GetTileStore())
+    {
+        TileStore->SetWorldLayout(GetActorLocation(), TileStore->GetSpacing(), AnchorTile);
+    }
+}
+
+void AHexManager::UpdateGridAnchor()
 {
+    TArray<FVector> ViewerLocations;
+    GetViewerLocations(ViewerLocations);
+    if (ViewerLocations.IsEmpty()) return;
+
+    // There is one anchor per grid, with players far apart the first one keeps the precision
+    const FVector ViewerLocation = ViewerLocations[0];
+    if (FVector::Dist2D(ViewerLocation, GetActorLocation()) < RebaseDistance) return;
+
+    const FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
+
+    RebaseGrid(TileStore->WorldToTileCoord(ViewerLocation));
+
     UWorld* World = GetWorld();
-    if (!World) return;
+    if (bRebaseWorldOrigin && World->GetWorldSettings()->bEnableWorldOriginRebasing)
+    {
+        // Every actor shifts so the player ends up at the origin, ApplyWorldOffset keeps the store in step
+        World->RequestNewWorldOrigin(World->OriginLocation + FIntVector(ViewerLocation));
+    }
+}
 
-    UHexGridSubsystem* Subsystem = World->GetSubsystem<UHexGridSubsystem>();
-    if (!Subsystem) return;
+void AHexManager::RebaseGrid(FIntPoint TileCoord)
+{
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return;
 
-    UFastNoiseWrapper* NoiseWrapper = Subsystem->NoiseWrapperLvl1;
-    if (!NoiseWrapper || !GrassMesh || !WaterMesh) return;
+    const FIntPoint NewAnchorTile = FHexTileStore::MakeAnchorTile(TileCoord);
+    if (NewAnchorTile == AnchorTile) return;
 
-    GrassMeshComp->SetStaticMesh(GrassMesh);
-    WaterMeshComp->SetStaticMesh(WaterMesh);
+    const double StartTime = FPlatformTime::Seconds();
 
-    NoiseWrapper->SetupFastNoise(
-        NoiseType, Seed, Frequency, Interp, Fractaltype,
-        Octaves, Lacunarity, Gain, CellularJitter,
-        CellularDistanceFunction, CellularReturnType);
+    // Both anchors have even coordinates, so the move between them is the same for every tile and exact in doubles
+    const FVector2D Shift = FHexGridLayout::OffsetToWorld64(NewAnchorTile - AnchorTile, TileStore->GetSpacing());
+    SetActorLocation(GetActorLocation() + FVector(Shift.X, Shift.Y, 0.0), false, nullptr, ETeleportType::TeleportPhysics);
 
-    if (!NoiseWrapper->IsInitialized()) return;
+    AnchorTile = NewAnchorTile;
+    TileStore->SetWorldLayout(GetActorLocation(), TileStore->GetSpacing(), AnchorTile);
 
-    DestroyTiles();
+    // Recomputed from the tile coordinates rather than shifted, instances near the new anchor get their precision back
+    int32 NumInstances = 0;
+    TileStore->ForEachTile([this, TileStore, &NumInstances](int32 TileIndex, const FIntPoint& TileCoord)
+    {
+        const int32 InstanceIndex = TileStore->GetInstanceIndex(TileIndex);
+        if (InstanceIndex == INDEX_NONE) return;
+
+        MeshComps[TileStore->GetMeshSlot(TileIndex)]->UpdateInstanceTransform(
+            InstanceIndex, FTransform(TileStore->GetTileLocalLocation(TileIndex)), false, false, true);
+        ++NumInstances;
+    });
+
+    // Chunk geometry is relative to its chunk, only the components move
+    for (const TPair<FIntPoint, UHexChunkCollisionComponent*>& Pair : ChunkCollision)
+    {
+        Pair.Value->SetRelativeLocation(TileStore->GetChunkLocalOrigin(Pair.Key));
+    }
+
+    for (const TPair<FIntPoint, FHexChunkProxy>& Pair : ChunkProxies)
+    {
+        if (Pair.Value.Component)
+        {
+            Pair.Value.Component->SetRelativeLocation(TileStore->GetChunkLocalOrigin(Pair.Key));
+        }
+    }
+
+    FinishInstanceUpdates();
+
+    UE_LOG(LogTemp, Display, TEXT("%s: rebased onto tile (%d, %d), moved %d instances in %.2f ms"),
+        *GetName(), AnchorTile.X, AnchorTile.Y, NumInstances, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+uint64 AHexManager::MakeBakeKey() const
+{
+    FXxHash64Builder Builder;
+    auto Add = [&Builder](const auto& Value) { Builder.Update(&Value, sizeof(Value)); };
+
+    Add(FHexGridCache::MakeKey(GetNoiseSettings(), MakeGenerationInputs()));
+    Add(BiomeLayoutHash);
+
+    for (const FSpawnableData& Data : Spawnables)
+    {
+        const FString ClassPath = GetPathNameSafe(Data.ActorClass);
+        Builder.Update(*ClassPath, ClassPath.Len() * sizeof(TCHAR));
+        Add(Data.SpawnAmount);
+        Add(Data.MinHeightOffset);
+        Add(Data.MaxHeightOffset);
+        Add(Data.bAllowStacking);
+        Add(Data.StackChance);
+        Add(Data.bRandomRotate);
+    }
 
-    for (int32 y = 0; y < GridHeight; ++y)
+    // 0 marks "not baked"
+    return FMath::Max<uint64>(Builder.Finalize().Hash, 1);
+}
+
+bool AHexManager::BakeGrid()
+{
+    if (bUseChunkStreaming || bGenerationInFlight || !SetupBiomes()) return false;
+
+    const FHexGenerationInputs Inputs = MakeGenerationInputs();
+    TArray<FIntPoint> ChunkCoords;
+    GetChunksInBounds(ChunkCoords);
+
+    // Built directly rather than through the subsystem, commandlet worlds aren't initialized
+    const FHexNoiseGenerator HeightNoise(GetNoiseSettings());
+    TOptional<FHexNoiseGenerator> MoistureNoise;
+    if (Inputs.bSampleMoisture)
+    {
+        MoistureNoise.Emplace(Inputs.MoistureSettings);
+    }
+
+    TArray<FHexChunkBuffer> ChunkBuffers;
+    GenerateChunkBuffers(Inputs, HeightNoise, MoistureNoise.GetPtrOrNull(), FString(), 0, false, ChunkCoords, ChunkBuffers);
+
+    for (UHierarchicalInstancedStaticMeshComponent* MeshComp : MeshComps)
+    {
+        MeshComp->ClearInstances();
+    }
+
+    BakedGrid = FHexBakedGrid();
+
+    TArray<TArray<FTransform>> Transforms;
+    Transforms.SetNum(FreeInstances.Num());
+
+    // Filled the way RestoreBakedGrid fills the subsystem's store, so spawn tiles come out exactly as they will at runtime
+    FHexTileStore TileStore;
+    ConfigureTileStore(TileStore);
+
+    for (const FHexChunkBuffer& ChunkBuffer : ChunkBuffers)
     {
-        for (int32 x = 0; x < GridWidth; ++x)
+        for (int32 i = 0; i < ChunkBuffer.TileCoords.Num(); ++i)
         {
-            const bool bOddRow = (y % 2 == 1);
-            const float XPos = bOddRow
-                ? (x * Settings->TileHorizontalOffset) + Settings->OddRowHorizontalOffset
-                : x * Settings->TileHorizontalOffset;
-            const float YPos = y * Settings->TileVerticalOffset;
+            const FVector& LocalPos = ChunkBuffer.LocalPositions[i];
+            const uint8 Biome = ChunkBuffer.Biomes[i];
+            TArray<FTransform>& SlotTransforms = Transforms[ActiveTileBiomes[Biome].MeshSlot];
+
+            BakedGrid.TileCoords.Add(ChunkBuffer.TileCoords[i]);
+            BakedGrid.Heights.Add(LocalPos.Z);
+            BakedGrid.Biomes.Add(Biome);
+            BakedGrid.InstanceIndices.Add(SlotTransforms.Num());
 
-            const float NoiseValue = NoiseWrapper->GetNoise2D(XPos, YPos);
-            const FVector LocalPos(XPos, YPos, NoiseValue * HeightStrength);
-            const FVector WorldPos = GetActorLocation() + LocalPos;
-            TilePositions.Add(WorldPos);
+            SlotTransforms.Add(FTransform(LocalPos));
 
-            UInstancedStaticMeshComponent* MeshComp = NoiseValue >= 0.f ? GrassMeshComp : WaterMeshComp;
-            MeshComp->AddInstance(FTransform(LocalPos));
+            const FIntPoint& TileCoord = ChunkBuffer.TileCoords[i];
+            const FIntPoint ChunkCoord = TileStore.GetChunkCoord(TileCoord);
+            int32 ChunkBase = TileStore.FindChunkBase(ChunkCoord);
+            if (ChunkBase == INDEX_NONE)
+            {
+                ChunkBase = TileStore.AddChunk(ChunkCoord);
+            }
+            TileStore.SetTile(ChunkBase + TileStore.GetLocalIndex(TileCoord), LocalPos.Z, Biome, BakedGrid.InstanceIndices.Last());
+        }
+    }
+
+    // Instances land at indices 0..N-1 of freshly cleared components, matching what was recorded above
+    for (int32 MeshSlot = 0; MeshSlot < Transforms.Num(); ++MeshSlot)
+    {
+        MeshComps[MeshSlot]->AddInstances(Transforms[MeshSlot], false, false, false);
+    }
+
+    for (int32 i = 0; i < BakedGrid.Biomes.Num(); ++i)
+    {
+        const uint8 Biome = BakedGrid.Biomes[i];
+        WriteInstanceCustomData(ActiveTileBiomes[Biome].MeshSlot, BakedGrid.InstanceIndices[i], Biome, 0.f, GetTileFog(BakedGrid.TileCoords[i]));
+    }
+
+    for (int32 MeshSlot = 0; MeshSlot < Transforms.Num(); ++MeshSlot)
+    {
+        MeshComps[MeshSlot]->BuildTreeIfOutdated(false, true);
+    }
+
+    TArray<FVector> TilePositions;
+    TArray<FIntPoint> TileCoords;
+    GetSpawnTiles(TileStore, TilePositions, TileCoords);
+    BuildSpawnPlan(Seed, Spawnables, TilePositions, TileCoords, BakedGrid.SpawnPlan);
+    BakedGrid.Key = MakeBakeKey();
+
+    UE_LOG(LogTemp, Display, TEXT("%s: baked %d tiles and %d spawns"), *GetName(), BakedGrid.TileCoords.Num(), BakedGrid.SpawnPlan.Num());
+    return true;
+}
+
+bool AHexManager::RestoreBakedGrid()
+{
+    const int32 NumTiles = BakedGrid.TileCoords.Num();
+    if (BakedGrid.Key != MakeBakeKey()
+        || BakedGrid.Heights.Num() != NumTiles
+        || BakedGrid.Biomes.Num() != NumTiles
+        || BakedGrid.InstanceIndices.Num() != NumTiles)
+    {
+        return false;
+    }
+
+    ResetTileStore();
+    FHexTileStore* TileStore = GetTileStore();
+    if (!TileStore) return false;
+
+    for (int32 i = 0; i < NumTiles; ++i)
+    {
+        const uint8 Biome = BakedGrid.Biomes[i];
+        const int32 InstanceIndex = BakedGrid.InstanceIndices[i];
+
+        // The saved instances have to be the ones the bake recorded
+        if (!ActiveTileBiomes.IsValidIndex(Biome)
+            || InstanceIndex >= MeshComps[ActiveTileBiomes[Biome].MeshSlot]->GetInstanceCount())
+        {
+            ResetTileStore();
+            return false;
+        }
+
+        const FIntPoint& TileCoord = BakedGrid.TileCoords[i];
+        const FIntPoint ChunkCoord = TileStore->GetChunkCoord(TileCoord);
+        int32 ChunkBase = TileStore->FindChunkBase(ChunkCoord);
+        if (ChunkBase == INDEX_NONE)
+        {
+            ChunkBase = TileStore->AddChunk(ChunkCoord);
         }
+
+        TileStore->SetTile(ChunkBase + TileStore->GetLocalIndex(TileCoord), BakedGrid.Heights[i], Biome, InstanceIndex);
+        MarkCollisionDirty(ChunkCoord);
     }
 
-    // Delay until navmesh is ready
-    GetWorldTimerManager().SetTimerForNextTick(this, &AHexManager::SpawnEnemiesAfterNavMeshReady);
+    UpdateChunkCollision();
+    bBakedGridRestored = true;
+    return true;
 }
 
 void AHexManager::SpawnEnemiesAfterNavMeshReady()
@@ -101,8 +2366,7 @@ void AHexManager::SpawnEnemiesAfterNavMeshReady()
 
     if (NavSys->IsNavigationBeingBuiltOrLocked(GetWorld()))
     {
-        FTimerHandle RetryHandle;
-        GetWorldTimerManager().SetTimer(RetryHandle, this, &AHexManager::SpawnEnemiesAfterNavMeshReady, 0.25f, false);
+        GetWorldTimerManager().SetTimer(SpawnTimer, this, &AHexManager::SpawnEnemiesAfterNavMeshReady, 0.25f, false);
         return;
     }
 
@@ -112,71 +2376,296 @@ void AHexManager::SpawnEnemiesAfterNavMeshReady()
 
 void AHexManager::SpawnAllActors(const TArray<FSpawnableData>& InSpawnables)
 {
-    UWorld* World = GetWorld();
-    if (!World || TilePositions.IsEmpty()) return;
+    TArray<FVector> TilePositions;
+    TArray<FIntPoint> TileCoords;
+    GetSpawnTiles(TilePositions, TileCoords);
+
+    TArray<FHexSpawnPlanEntry> SpawnPlan;
+    BuildSpawnPlan(Seed, InSpawnables, TilePositions, TileCoords, SpawnPlan);
+    SpawnFromPlan(SpawnPlan);
+
+    UE_LOG(LogTemp, Display, TEXT("%s: spawned %d actors, plan hash %016llx"), *GetName(), SpawnPlan.Num(), HashSpawnPlan(SpawnPlan));
+}
+
+void AHexManager::GetSpawnTiles(TArray<FVector>& OutTilePositions, TArray<FIntPoint>& OutTileCoords) const
+{
+    if (const FHexTileStore* TileStore = GetTileStore())
+    {
+        GetSpawnTiles(*TileStore, OutTilePositions, OutTileCoords);
+    }
+}
+
+void AHexManager::GetSpawnTiles(const FHexTileStore& TileStore, TArray<FVector>& OutTilePositions, TArray<FIntPoint>& OutTileCoords)
+{
+    // Spawn heights are offsets above the tile tops, so actors start just above the ground instead of settling onto it
+    TileStore.ForEachTile([&TileStore, &OutTilePositions, &OutTileCoords](int32 TileIndex, const FIntPoint& TileCoord)
+    {
+        const FVector TileLocation = TileStore.GetTileLocation(TileIndex);
+        OutTilePositions.Add(FVector(TileLocation.X, TileLocation.Y, TileStore.GetGroundHeight(TileIndex)));
+        OutTileCoords.Add(TileCoord);
+    });
+}
+
+void AHexManager::BuildSpawnPlan(int32 GridSeed, const TArray<FSpawnableData>& InSpawnables, const TArray<FVector>& TilePositions,
+                                 const TArray<FIntPoint>& TileCoords, TArray<FHexSpawnPlanEntry>& OutSpawnPlan)
+{
+    if (TilePositions.IsEmpty()) return;
+
+    // Tiles are drawn in coordinate order, so the plan doesn't depend on the order chunks were loaded or committed in
+    TArray<int32> TileOrder;
+    TileOrder.Reserve(TileCoords.Num());
+    for (int32 i = 0; i < TileCoords.Num(); ++i)
+    {
+        TileOrder.Add(i);
+    }
+    TileOrder.Sort([&TileCoords](int32 A, int32 B)
+    {
+        return TileCoords[A].Y != TileCoords[B].Y ? TileCoords[A].Y < TileCoords[B].Y : TileCoords[A].X < TileCoords[B].X;
+    });
+
+    struct FSpawnDraw
+    {
+        bool bStack = false;
+        float StackPick = 0.f;
+        float HeightOffset = 0.f;
+        float Yaw = 0.f;
+    };
+
+    // A spawnable can lose at most every tile claimed before it, so it reserves that many candidates on top of its own
+    TArray<int32> ClaimsBefore;
+    ClaimsBefore.SetNumZeroed(InSpawnables.Num());
+    for (int32 SpawnableIndex = 1; SpawnableIndex < InSpawnables.Num(); ++SpawnableIndex)
+    {
+        const FSpawnableData& Previous = InSpawnables[SpawnableIndex - 1];
+        ClaimsBefore[SpawnableIndex] = ClaimsBefore[SpawnableIndex - 1] + (Previous.ActorClass ? FMath::Max(Previous.SpawnAmount, 0) : 0);
+    }
+
+    // Each spawnable draws only from its own stream, so the draws don't depend on each other and run side by side
+    TArray<TArray<FSpawnDraw>> Draws;
+    TArray<TArray<int32>> Candidates;
+    Draws.SetNum(InSpawnables.Num());
+    Candidates.SetNum(InSpawnables.Num());
+
+    ParallelFor(InSpawnables.Num(), [&](int32 SpawnableIndex)
+    {
+        const FSpawnableData& Data = InSpawnables[SpawnableIndex];
+        if (!Data.ActorClass || Data.SpawnAmount <= 0) return;
+
+        FRandomStream Random = HexRandom::MakeStream(GridSeed, HexRandom::EStream::SpawnPlan, SpawnableIndex);
+
+        for (int32 i = 0; i < Data.SpawnAmount; ++i)
+        {
+            FSpawnDraw& Draw = Draws[SpawnableIndex].AddDefaulted_GetRef();
+            Draw.bStack = Data.bAllowStacking && Random.FRand() < Data.StackChance;
+            Draw.StackPick = Random.FRand();
+            Draw.HeightOffset = Random.FRandRange(Data.MinHeightOffset, Data.MaxHeightOffset);
+            Draw.Yaw = Data.bRandomRotate ? Random.FRandRange(0.f, 360.f) : 0.f;
+        }
+
+        // The first tiles of a random permutation, by partial Fisher-Yates
+        TArray<int32>& Reserved = Candidates[SpawnableIndex];
+        Reserved = TileOrder;
+        const int32 NumReserved = FMath::Min(Reserved.Num(), Data.SpawnAmount + ClaimsBefore[SpawnableIndex]);
+        for (int32 i = 0; i < NumReserved; ++i)
+        {
+            Reserved.Swap(i, Random.RandRange(i, Reserved.Num() - 1));
+        }
+        Reserved.SetNum(NumReserved);
+    });
 
-    // Track how many actors are stacked per tile
+    // Conflicts are settled in list order, a spawnable passes over reserved tiles the ones before it already took
     TMap<int32, int32> TileStackCounts;
-    // Track which tiles are already occupied
     TSet<int32> UsedTiles;
+    // Keeps the order tiles were taken in for stacking picks
+    TArray<int32> UsedTileList;
 
-    for (const FSpawnableData& Data : InSpawnables)
+    for (int32 SpawnableIndex = 0; SpawnableIndex < InSpawnables.Num(); ++SpawnableIndex)
     {
-        if (!Data.ActorClass || Data.SpawnAmount <= 0) continue;
+        const FSpawnableData& Data = InSpawnables[SpawnableIndex];
+        const TArray<int32>& Reserved = Candidates[SpawnableIndex];
+        int32 NextCandidate = 0;
 
-        for (int32 i = 0; i < Data.SpawnAmount; ++i)
+        for (const FSpawnDraw& Draw : Draws[SpawnableIndex])
         {
-            int32 TileIndex = -1;
+            int32 TileIndex = INDEX_NONE;
 
-            // If stacking chance succeeds and there are already used tiles, pick one to stack on
-            if (Data.bAllowStacking && FMath::FRand() < Data.StackChance && UsedTiles.Num() > 0)
+            if (Draw.bStack && UsedTileList.Num() > 0)
             {
-                // Pick a random used tile to stack on
-                TileIndex = UsedTiles.Array()[FMath::RandRange(0, UsedTiles.Num() - 1)];
+                // Stack on a tile something already stands on
+                TileIndex = UsedTileList[FMath::Min(FMath::FloorToInt32(Draw.StackPick * UsedTileList.Num()), UsedTileList.Num() - 1)];
             }
             else
             {
-                // Pick a completely new tile (not used yet)
-                int32 SafetyCounter = 0;
-                do
+                while (NextCandidate < Reserved.Num() && UsedTiles.Contains(Reserved[NextCandidate]))
                 {
-                    TileIndex = FMath::RandRange(0, TilePositions.Num() - 1);
-                    SafetyCounter++;
-                } while (UsedTiles.Contains(TileIndex) && SafetyCounter < 200);
+                    ++NextCandidate;
+                }
 
-                if (SafetyCounter >= 200)
+                if (NextCandidate == Reserved.Num())
                 {
                     UE_LOG(LogTemp, Warning, TEXT("SpawnAllActors: ran out of unique tiles for %s"), *GetNameSafe(Data.ActorClass));
                     break;
                 }
 
+                TileIndex = Reserved[NextCandidate++];
                 UsedTiles.Add(TileIndex);
+                UsedTileList.Add(TileIndex);
             }
 
-            // Base position of that tile
-            FVector BasePos = TilePositions[TileIndex];
-            float HeightOffset = FMath::FRandRange(Data.MinHeightOffset, Data.MaxHeightOffset);
-
             // Stack on previous ones if tile was already used
             int32& StackCount = TileStackCounts.FindOrAdd(TileIndex);
-            if (StackCount > 0)
-            {
-                HeightOffset += StackCount * 100.f;
-            }
+            const float HeightOffset = Draw.HeightOffset + StackCount * 100.f;
+
+            FHexSpawnPlanEntry& Entry = OutSpawnPlan.AddDefaulted_GetRef();
+            Entry.ActorClass = Data.ActorClass;
+            Entry.Transform = FTransform(FRotator(0.f, Draw.Yaw, 0.f), TilePositions[TileIndex] + FVector(0, 0, HeightOffset));
+            Entry.TileCoord = TileCoords[TileIndex];
+            StackCount++;
+        }
+    }
+}
+
+uint64 AHexManager::HashSpawnPlan(TConstArrayView<FHexSpawnPlanEntry> SpawnPlan)
+{
+    FXxHash64Builder Builder;
+    auto Add = [&Builder](const auto& Value) { Builder.Update(&Value, sizeof(Value)); };
+
+    for (const FHexSpawnPlanEntry& Entry : SpawnPlan)
+    {
+        const FString ClassPath = GetPathNameSafe(Entry.ActorClass);
+        Builder.Update(*ClassPath, ClassPath.Len() * sizeof(TCHAR));
+        Add(Entry.TileCoord);
+
+        const FVector Location = Entry.Transform.GetLocation();
+        const FQuat Rotation = Entry.Transform.GetRotation();
+        Add(Location.X);
+        Add(Location.Y);
+        Add(Location.Z);
+        Add(Rotation.X);
+        Add(Rotation.Y);
+        Add(Rotation.Z);
+        Add(Rotation.W);
+    }
+
+    return Builder.Finalize().Hash;
+}
+
+int64 AHexManager::GetSpawnPlanHash() const
+{
+    TArray<FVector> TilePositions;
+    TArray<FIntPoint> TileCoords;
+    GetSpawnTiles(TilePositions, TileCoords);
+
+    TArray<FHexSpawnPlanEntry> SpawnPlan;
+    BuildSpawnPlan(Seed, Spawnables, TilePositions, TileCoords, SpawnPlan);
+    return static_cast<int64>(HashSpawnPlan(SpawnPlan));
+}
+
+void AHexManager::SpawnFromPlan(const TArray<FHexSpawnPlanEntry>& SpawnPlan)
+{
+    UWorld* World = GetWorld();
+    if (!World) return;
 
-            FVector SpawnLoc = BasePos + FVector(0, 0, HeightOffset);
-            FRotator SpawnRot = Data.bRandomRotate
-                ? FRotator(0.f, FMath::FRandRange(0.f, 360.f), 0.f)
-                : FRotator::ZeroRotator;
+    for (const FHexSpawnPlanEntry& Entry : SpawnPlan)
+    {
+        if (!Entry.ActorClass) continue;
 
-            if (AActor* Spawned = World->SpawnActor<AActor>(Data.ActorClass, SpawnLoc, SpawnRot))
+        if (AActor* Spawned = World->SpawnActor<AActor>(Entry.ActorClass, Entry.Transform))
+        {
+            if (AHexTile* SpawnedTile = Cast<AHexTile>(Spawned))
             {
-                SpawnedActors.Add(Spawned);
-                StackCount++;
+                SpawnedTile->TileIndex = Entry.TileCoord;
             }
+
+            SpawnedActors.Add(Spawned);
+        }
+    }
+}
+
+#if WITH_EDITOR
+bool AHexManager::ShouldPreviewSpawns() const
+{
+    const UWorld* World = GetWorld();
+    return bPreviewSpawnsInEditor && World && !World->IsGameWorld();
+}
+
+void AHexManager::UpdateSpawnPreview()
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<FVector> TilePositions;
+    TArray<FIntPoint> TileCoords;
+    GetSpawnTiles(TilePositions, TileCoords);
+
+    TArray<FHexSpawnPlanEntry> SpawnPlan;
+    BuildSpawnPlan(Seed, Spawnables, TilePositions, TileCoords, SpawnPlan);
+
+    // The previous preview is replaced wholesale, its components are kept and refilled
+    ClearSpawnPreview();
+
+    TMap<UInstancedStaticMeshComponent*, TArray<FTransform>> PreviewTransforms;
+    for (const FHexSpawnPlanEntry& Entry : SpawnPlan)
+    {
+        if (UInstancedStaticMeshComponent* PreviewComp = GetSpawnPreviewComp(Entry.ActorClass))
+        {
+            PreviewTransforms.FindOrAdd(PreviewComp).Add(Entry.Transform);
+        }
+    }
+
+    for (TPair<UInstancedStaticMeshComponent*, TArray<FTransform>>& Pair : PreviewTransforms)
+    {
+        Pair.Key->AddInstances(Pair.Value, false, true, false);
+        Pair.Key->SetVisibility(true);
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("%s: previewed %d spawns of %d classes in %.2f ms"),
+        *GetName(), SpawnPlan.Num(), PreviewTransforms.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+UInstancedStaticMeshComponent* AHexManager::GetSpawnPreviewComp(TSubclassOf<AActor> ActorClass)
+{
+    if (!ActorClass) return nullptr;
+
+    if (UInstancedStaticMeshComponent* const* PreviewComp = SpawnPreviewComps.Find(ActorClass))
+        return *PreviewComp;
+
+    // Native mesh components of the class are on its default object, anything else shows as the preview mesh
+    UStaticMesh* Mesh = SpawnPreviewMesh;
+    const UStaticMeshComponent* ClassMeshComp = ActorClass->GetDefaultObject<AActor>()->FindComponentByClass<UStaticMeshComponent>();
+    if (ClassMeshComp && ClassMeshComp->GetStaticMesh())
+    {
+        Mesh = ClassMeshComp->GetStaticMesh();
+    }
+    if (!Mesh)
+    {
+        Mesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+    }
+
+    UInstancedStaticMeshComponent* PreviewComp = NewObject<UInstancedStaticMeshComponent>(this, NAME_None, RF_Transient);
+    PreviewComp->SetupAttachment(RootComponent);
+    PreviewComp->SetMobility(EComponentMobility::Movable);
+    PreviewComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    PreviewComp->SetCanEverAffectNavigation(false);
+    PreviewComp->SetStaticMesh(Mesh);
+    PreviewComp->bIsEditorOnly = true;
+    PreviewComp->RegisterComponent();
+
+    SpawnPreviewComps.Add(ActorClass, PreviewComp);
+    return PreviewComp;
+}
+
+void AHexManager::ClearSpawnPreview()
+{
+    for (const TPair<TSubclassOf<AActor>, UInstancedStaticMeshComponent*>& Pair : SpawnPreviewComps)
+    {
+        if (IsValid(Pair.Value))
+        {
+            Pair.Value->ClearInstances();
+            Pair.Value->SetVisibility(false);
         }
     }
 }
+#endif
 
 void AHexManager::SpawnAllActorsInEditor()
 {
@@ -0,0 +1,262 @@
+#include "HexMinimap.h"
+#include "HexGridSettings.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
+
+namespace HexMinimap
+{
+	// Rasterizes a random picture in full, edits a few tiles, redraws only their blocks and holds both against a full raster
+	void VerifyMinimap(const TArray<FString>& Args)
+	{
+		constexpr int32 GridSize = 128;
+		constexpr int32 NumEdits = 64;
+
+		FHexMinimapLayout Layout;
+		Layout.NumTiles = FIntPoint(GridSize, GridSize);
+		Layout.Spacing = GetDefault<UHexGridSettings>()->GetSpacing();
+		Layout.PixelsPerTile = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 1.f) : 4.f;
+
+		FHexMinimap Minimap;
+		Minimap.SetLayout(Layout);
+
+		FRandomStream Random(GridSize);
+		TArray<FColor> TileColours;
+		TileColours.SetNumUninitialized(GridSize * GridSize);
+		for (int32 i = 0; i < TileColours.Num(); ++i)
+		{
+			TileColours[i] = FColor(Random.RandRange(0, 255), Random.RandRange(0, 255), Random.RandRange(0, 255), 255);
+			Minimap.SetTileColour(FIntPoint(i % GridSize, i / GridSize), TileColours[i]);
+		}
+
+		const int32 TotalBlocks = Minimap.GetNumDirtyBlocks();
+		const double FullStart = FPlatformTime::Seconds();
+		Minimap.RasterizeNow();
+		const double FullMs = (FPlatformTime::Seconds() - FullStart) * 1000.0;
+
+		for (int32 i = 0; i < NumEdits; ++i)
+		{
+			const FIntPoint TileCoord(Random.RandRange(0, GridSize - 1), Random.RandRange(0, GridSize - 1));
+			const FColor Colour(Random.RandRange(0, 255), Random.RandRange(0, 255), Random.RandRange(0, 255), 255);
+			TileColours[TileCoord.Y * GridSize + TileCoord.X] = Colour;
+			Minimap.SetTileColour(TileCoord, Colour);
+		}
+
+		const int32 EditedBlocks = Minimap.GetNumDirtyBlocks();
+		const double EditStart = FPlatformTime::Seconds();
+		Minimap.RasterizeNow();
+		const double EditMs = (FPlatformTime::Seconds() - EditStart) * 1000.0;
+
+		const FIntPoint TextureSize = Layout.GetTextureSize();
+		TArray<FColor> Expected;
+		Expected.SetNumUninitialized(TextureSize.X * TextureSize.Y);
+		FHexMinimap::Rasterize(Layout, TileColours, FIntRect(FIntPoint::ZeroValue, TextureSize), Expected);
+
+		const TConstArrayView<FColor> Pixels = Minimap.GetPixels();
+		const bool bMatch = Pixels.Num() == Expected.Num() && FMemory::Memcmp(Pixels.GetData(), Expected.GetData(), Expected.Num() * sizeof(FColor)) == 0;
+
+		UE_LOG(LogTemp, Display, TEXT("HexGrid minimap %dx%d px: full raster %d blocks %8.3f ms, %d tile edits redrew %d blocks %8.3f ms%s"),
+			TextureSize.X, TextureSize.Y, TotalBlocks, FullMs, NumEdits, EditedBlocks, EditMs, bMatch ? TEXT("") : TEXT(", MISMATCH"));
+	}
+
+	static FAutoConsoleCommandWithArgs VerifyMinimapCommand(
+		TEXT("HexGrid.VerifyMinimap"),
+		TEXT("Checks incremental minimap rasters against full ones on a synthetic grid. Optional pixels per tile"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&VerifyMinimap));
+}
+
+FIntPoint FHexMinimapLayout::GetTextureSize() const
+{
+	if (NumTiles.X <= 0 || NumTiles.Y <= 0) return FIntPoint::ZeroValue;
+
+	// Odd rows stick out half a column to the right
+	const float WorldPerPixel = GetWorldPerPixel();
+	return FIntPoint(
+		FMath::CeilToInt((NumTiles.X + 0.5f) * PixelsPerTile),
+		FMath::CeilToInt(NumTiles.Y * Spacing.Row / WorldPerPixel));
+}
+
+FIntRect FHexMinimapLayout::GetTilePixelRect(const FIntPoint& TileCoord) const
+{
+	const float WorldPerPixel = GetWorldPerPixel();
+	const FVector2f Centre = FHexGridLayout::OffsetToWorld(FHexOffset(TileCoord - MinTile), Spacing);
+	const float CentreX = (Centre.X + 0.5f * Spacing.Column) / WorldPerPixel;
+	const float CentreY = (Centre.Y + 0.5f * Spacing.Row) / WorldPerPixel;
+
+	// Pointy hexes reach half a column sideways and two thirds of a row up and down, plus a pixel for rounding
+	const float HalfWidth = 0.5f * Spacing.Column / WorldPerPixel + 1.f;
+	const float HalfHeight = Spacing.Row / (1.5f * WorldPerPixel) + 1.f;
+
+	const FIntPoint TextureSize = GetTextureSize();
+	return FIntRect(
+		FMath::Clamp(FMath::FloorToInt(CentreX - HalfWidth), 0, TextureSize.X),
+		FMath::Clamp(FMath::FloorToInt(CentreY - HalfHeight), 0, TextureSize.Y),
+		FMath::Clamp(FMath::CeilToInt(CentreX + HalfWidth), 0, TextureSize.X),
+		FMath::Clamp(FMath::CeilToInt(CentreY + HalfHeight), 0, TextureSize.Y));
+}
+
+FHexMinimap::~FHexMinimap()
+{
+	if (RasterTask.IsValid())
+	{
+		RasterTask.Wait();
+	}
+}
+
+void FHexMinimap::SetLayout(const FHexMinimapLayout& InLayout)
+{
+	if (RasterTask.IsValid())
+	{
+		RasterTask.Wait();
+		RasterTask = UE::Tasks::FTask();
+	}
+
+	Layout = InLayout;
+	Layout.MinTile = FIntPoint(InLayout.MinTile.X & ~1, InLayout.MinTile.Y & ~1);
+	Layout.NumTiles = FIntPoint(FMath::Max(InLayout.NumTiles.X, 0), FMath::Max(InLayout.NumTiles.Y, 0));
+
+	TextureSize = Layout.GetTextureSize();
+	NumBlocks = FIntPoint(FMath::DivideAndRoundUp(TextureSize.X, BlockSize), FMath::DivideAndRoundUp(TextureSize.Y, BlockSize));
+
+	// A fresh array rather than a reset one, a finished raster may still hold the old
+	TileColours = MakeShared<TArray<FColor>, ESPMode::ThreadSafe>();
+	TileColours->SetNumZeroed(Layout.NumTiles.X * Layout.NumTiles.Y);
+
+	Pixels.Reset();
+	Pixels.SetNumZeroed(TextureSize.X * TextureSize.Y);
+	DirtyBlocks.Init(true, NumBlocks.X * NumBlocks.Y);
+	RasterBlocks.Reset();
+}
+
+void FHexMinimap::SetTileColour(const FIntPoint& TileCoord, const FColor& Colour)
+{
+	if (!IsInWindow(TileCoord)) return;
+
+	const int32 Index = (TileCoord.Y - Layout.MinTile.Y) * Layout.NumTiles.X + TileCoord.X - Layout.MinTile.X;
+	if ((*TileColours)[Index] == Colour) return;
+
+	if (!TileColours.IsUnique())
+	{
+		TileColours = MakeShared<TArray<FColor>, ESPMode::ThreadSafe>(*TileColours);
+	}
+	(*TileColours)[Index] = Colour;
+
+	const FIntRect PixelRect = Layout.GetTilePixelRect(TileCoord);
+	if (PixelRect.IsEmpty()) return;
+
+	for (int32 BlockY = PixelRect.Min.Y / BlockSize; BlockY <= (PixelRect.Max.Y - 1) / BlockSize; ++BlockY)
+	{
+		for (int32 BlockX = PixelRect.Min.X / BlockSize; BlockX <= (PixelRect.Max.X - 1) / BlockSize; ++BlockX)
+		{
+			DirtyBlocks[BlockY * NumBlocks.X + BlockX] = true;
+		}
+	}
+}
+
+bool FHexMinimap::IsInWindow(const FIntPoint& TileCoord) const
+{
+	return TileCoord.X >= Layout.MinTile.X && TileCoord.Y >= Layout.MinTile.Y
+		&& TileCoord.X < Layout.MinTile.X + Layout.NumTiles.X && TileCoord.Y < Layout.MinTile.Y + Layout.NumTiles.Y;
+}
+
+bool FHexMinimap::LaunchRaster()
+{
+	if (IsRasterRunning()) return false;
+
+	TakeDirtyBlocks();
+	if (RasterBlocks.IsEmpty()) return false;
+
+	// The layout can't change under the task, SetLayout waits for it, but the colours can so it keeps its own reference
+	RasterTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [this, Colours = TileColours]()
+	{
+		ParallelFor(RasterBlocks.Num(), [this, &Colours](int32 i)
+		{
+			Rasterize(Layout, *Colours, GetBlockRect(RasterBlocks[i]), Pixels);
+		});
+	});
+	return true;
+}
+
+bool FHexMinimap::FinishRaster(UTexture2D* Texture)
+{
+	if (!RasterTask.IsValid() || !RasterTask.IsCompleted()) return false;
+
+	RasterTask = UE::Tasks::FTask();
+
+	if (!Texture || RasterBlocks.IsEmpty() || Texture->GetSizeX() != TextureSize.X || Texture->GetSizeY() != TextureSize.Y) return true;
+
+	// Blocks are stacked into one buffer BlockSize pixels wide, the render thread frees it with the regions once uploaded
+	const int32 NumRegions = RasterBlocks.Num();
+	const uint32 SrcPitch = BlockSize * sizeof(FColor);
+	FUpdateTextureRegion2D* Regions = new FUpdateTextureRegion2D[NumRegions];
+	uint8* SrcData = static_cast<uint8*>(FMemory::Malloc(NumRegions * BlockSize * SrcPitch));
+
+	for (int32 i = 0; i < NumRegions; ++i)
+	{
+		const FIntRect Rect = GetBlockRect(RasterBlocks[i]);
+		Regions[i] = FUpdateTextureRegion2D(Rect.Min.X, Rect.Min.Y, 0, i * BlockSize, Rect.Width(), Rect.Height());
+
+		for (int32 y = Rect.Min.Y; y < Rect.Max.Y; ++y)
+		{
+			FMemory::Memcpy(SrcData + (i * BlockSize + y - Rect.Min.Y) * SrcPitch, &Pixels[y * TextureSize.X + Rect.Min.X], Rect.Width() * sizeof(FColor));
+		}
+	}
+
+	Texture->UpdateTextureRegions(0, NumRegions, Regions, SrcPitch, sizeof(FColor), SrcData,
+		[](uint8* InSrcData, const FUpdateTextureRegion2D* InRegions)
+		{
+			FMemory::Free(InSrcData);
+			delete[] InRegions;
+		});
+	return true;
+}
+
+void FHexMinimap::RasterizeNow()
+{
+	check(!IsRasterRunning());
+
+	TakeDirtyBlocks();
+	for (const int32 Block : RasterBlocks)
+	{
+		Rasterize(Layout, *TileColours, GetBlockRect(Block), Pixels);
+	}
+}
+
+void FHexMinimap::Rasterize(const FHexMinimapLayout& Layout, TConstArrayView<FColor> TileColours, const FIntRect& PixelRect, TArrayView<FColor> OutPixels)
+{
+	const int32 Width = Layout.GetTextureSize().X;
+	const float WorldPerPixel = Layout.GetWorldPerPixel();
+
+	// Pixel centres relative to the centre of MinTile, whose hex starts half a column and half a row into the texture
+	const float OriginX = 0.5f * WorldPerPixel - 0.5f * Layout.Spacing.Column;
+	const float OriginY = 0.5f * WorldPerPixel - 0.5f * Layout.Spacing.Row;
+
+	for (int32 y = PixelRect.Min.Y; y < PixelRect.Max.Y; ++y)
+	{
+		const float LocalY = OriginY + y * WorldPerPixel;
+		FColor* Row = OutPixels.GetData() + y * Width;
+
+		for (int32 x = PixelRect.Min.X; x < PixelRect.Max.X; ++x)
+		{
+			const FHexOffset Offset = FHexGridLayout::WorldToOffset(OriginX + x * WorldPerPixel, LocalY, Layout.Spacing);
+			const bool bInside = Offset.Col >= 0 && Offset.Row >= 0 && Offset.Col < Layout.NumTiles.X && Offset.Row < Layout.NumTiles.Y;
+			Row[x] = bInside ? TileColours[Offset.Row * Layout.NumTiles.X + Offset.Col] : FColor(0, 0, 0, 0);
+		}
+	}
+}
+
+FIntRect FHexMinimap::GetBlockRect(int32 Block) const
+{
+	const FIntPoint Min((Block % NumBlocks.X) * BlockSize, (Block / NumBlocks.X) * BlockSize);
+	return FIntRect(Min, FIntPoint(FMath::Min(Min.X + BlockSize, TextureSize.X), FMath::Min(Min.Y + BlockSize, TextureSize.Y)));
+}
+
+void FHexMinimap::TakeDirtyBlocks()
+{
+	RasterBlocks.Reset();
+	for (TConstSetBitIterator<> It(DirtyBlocks); It; ++It)
+	{
+		RasterBlocks.Add(It.GetIndex());
+	}
+	DirtyBlocks.Init(false, DirtyBlocks.Num());
+}
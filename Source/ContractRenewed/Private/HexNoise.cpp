@@ -0,0 +1,298 @@
+#include "HexNoise.h"
+#include <random>
+
+namespace HexNoise
+{
+	static constexpr float Sqrt3 = 1.7320508075688772935274463415059f;
+	static constexpr float F2 = 0.5f * (Sqrt3 - 1.0f);
+	static constexpr float G2 = (3.0f - Sqrt3) / 6.0f;
+
+	static constexpr float GradX[12] = { 1, -1, 1, -1, 1, -1, 1, -1, 0, 0, 0, 0 };
+	static constexpr float GradY[12] = { 1, 1, -1, -1, 0, 0, 0, 0, 1, -1, 1, -1 };
+
+	// FastNoise floors negative integers one step down, kept for parity with the wrapper
+	FORCEINLINE int32 FastFloor(float F)
+	{
+		return F >= 0.f ? static_cast<int32>(F) : static_cast<int32>(F) - 1;
+	}
+
+	FORCEINLINE VectorRegister4Float FastFloor4(const VectorRegister4Float& F)
+	{
+		const VectorRegister4Float Truncated = VectorTruncate(F);
+		return VectorSelect(VectorCompareLT(F, VectorZeroFloat()), VectorSubtract(Truncated, VectorOneFloat()), Truncated);
+	}
+
+	FORCEINLINE float Corner(float X, float Y, uint8 Grad)
+	{
+		float T = 0.5f - X * X - Y * Y;
+		if (T < 0.f) return 0.f;
+
+		T *= T;
+		return T * T * (X * GradX[Grad] + Y * GradY[Grad]);
+	}
+
+	FORCEINLINE VectorRegister4Float Corner4(const VectorRegister4Float& X, const VectorRegister4Float& Y,
+	                                         const VectorRegister4Float& GX, const VectorRegister4Float& GY)
+	{
+		VectorRegister4Float T = VectorSubtract(VectorSubtract(VectorSetFloat1(0.5f), VectorMultiply(X, X)), VectorMultiply(Y, Y));
+		T = VectorMax(T, VectorZeroFloat());
+		T = VectorMultiply(T, T);
+		return VectorMultiply(VectorMultiply(T, T), VectorAdd(VectorMultiply(X, GX), VectorMultiply(Y, GY)));
+	}
+}
+
+bool FHexNoiseSettings::operator==(const FHexNoiseSettings& Other) const
+{
+	return NoiseType == Other.NoiseType && Seed == Other.Seed && Frequency == Other.Frequency && Interp == Other.Interp
+		&& FractalType == Other.FractalType && Octaves == Other.Octaves && Lacunarity == Other.Lacunarity && Gain == Other.Gain
+		&& CellularJitter == Other.CellularJitter && CellularDistanceFunction == Other.CellularDistanceFunction
+		&& CellularReturnType == Other.CellularReturnType;
+}
+
+uint32 GetTypeHash(const FHexNoiseSettings& NoiseSettings)
+{
+	uint32 Hash = HashCombineFast(GetTypeHash(NoiseSettings.NoiseType), GetTypeHash(NoiseSettings.Seed));
+	Hash = HashCombineFast(Hash, GetTypeHash(NoiseSettings.Frequency));
+	Hash = HashCombineFast(Hash, GetTypeHash(NoiseSettings.Interp));
+	Hash = HashCombineFast(Hash, GetTypeHash(NoiseSettings.FractalType));
+	Hash = HashCombineFast(Hash, GetTypeHash(NoiseSettings.Octaves));
+	Hash = HashCombineFast(Hash, GetTypeHash(NoiseSettings.Lacunarity));
+	Hash = HashCombineFast(Hash, GetTypeHash(NoiseSettings.Gain));
+	Hash = HashCombineFast(Hash, GetTypeHash(NoiseSettings.CellularJitter));
+	Hash = HashCombineFast(Hash, GetTypeHash(NoiseSettings.CellularDistanceFunction));
+	return HashCombineFast(Hash, GetTypeHash(NoiseSettings.CellularReturnType));
+}
+
+FHexSimplexNoise::FHexSimplexNoise(const FHexNoiseSettings& InSettings)
+	: Frequency(InSettings.Frequency)
+	, Lacunarity(InSettings.Lacunarity)
+	, Gain(InSettings.Gain)
+	, Octaves(FMath::Clamp(InSettings.Octaves, 1, 256))
+	, bFractal(InSettings.NoiseType == EFastNoise_NoiseType::SimplexFractal)
+{
+	// Same shuffle as FastNoise::SetSeed
+	std::mt19937_64 Generator(static_cast<uint64>(static_cast<int64>(InSettings.Seed)));
+
+	for (int32 i = 0; i < 256; ++i)
+	{
+		Perm[i] = static_cast<uint8>(i);
+	}
+
+	for (int32 j = 0; j < 256; ++j)
+	{
+		const int32 k = static_cast<int32>(Generator() % (256 - j)) + j;
+		const uint8 Swapped = Perm[j];
+		Perm[j] = Perm[j + 256] = Perm[k];
+		Perm[k] = Swapped;
+		Perm12[j] = Perm12[j + 256] = Perm[j] % 12;
+	}
+
+	float Amp = Gain;
+	float AmpFractal = 1.f;
+	for (int32 i = 1; i < Octaves; ++i)
+	{
+		AmpFractal += Amp;
+		Amp *= Gain;
+	}
+	FractalBounding = 1.f / AmpFractal;
+}
+
+bool FHexSimplexNoise::SupportsSettings(const FHexNoiseSettings& InSettings)
+{
+	return InSettings.NoiseType == EFastNoise_NoiseType::Simplex
+		|| (InSettings.NoiseType == EFastNoise_NoiseType::SimplexFractal && InSettings.FractalType == EFastNoise_FractalType::FBM);
+}
+
+float FHexSimplexNoise::GetNoise2D(float X, float Y) const
+{
+	X *= Frequency;
+	Y *= Frequency;
+
+	if (!bFractal)
+		return SingleSimplex(0, X, Y);
+
+	float Sum = SingleSimplex(Perm[0], X, Y);
+	float Amp = 1.f;
+	for (int32 i = 1; i < Octaves; ++i)
+	{
+		X *= Lacunarity;
+		Y *= Lacunarity;
+		Amp *= Gain;
+		Sum += SingleSimplex(Perm[i], X, Y) * Amp;
+	}
+
+	return Sum * FractalBounding;
+}
+
+void FHexSimplexNoise::GetNoise2DBatch(TConstArrayView<float> X, TConstArrayView<float> Y, TArrayView<float> OutValues) const
+{
+	check(X.Num() == Y.Num() && OutValues.Num() >= X.Num());
+
+	const int32 Num = X.Num();
+	const int32 NumVectorized = Num & ~3;
+
+	const VectorRegister4Float VFrequency = VectorSetFloat1(Frequency);
+	const VectorRegister4Float VLacunarity = VectorSetFloat1(Lacunarity);
+	const VectorRegister4Float VFractalBounding = VectorSetFloat1(FractalBounding);
+
+	for (int32 i = 0; i < NumVectorized; i += 4)
+	{
+		VectorRegister4Float VX = VectorMultiply(VectorLoad(X.GetData() + i), VFrequency);
+		VectorRegister4Float VY = VectorMultiply(VectorLoad(Y.GetData() + i), VFrequency);
+
+		VectorRegister4Float Result;
+		if (!bFractal)
+		{
+			Result = SingleSimplex4(0, VX, VY);
+		}
+		else
+		{
+			Result = SingleSimplex4(Perm[0], VX, VY);
+			float Amp = 1.f;
+			for (int32 Octave = 1; Octave < Octaves; ++Octave)
+			{
+				VX = VectorMultiply(VX, VLacunarity);
+				VY = VectorMultiply(VY, VLacunarity);
+				Amp *= Gain;
+				Result = VectorAdd(Result, VectorMultiply(SingleSimplex4(Perm[Octave], VX, VY), VectorSetFloat1(Amp)));
+			}
+			Result = VectorMultiply(Result, VFractalBounding);
+		}
+
+		VectorStore(Result, OutValues.GetData() + i);
+	}
+
+	for (int32 i = NumVectorized; i < Num; ++i)
+	{
+		OutValues[i] = GetNoise2D(X[i], Y[i]);
+	}
+}
+
+float FHexSimplexNoise::SingleSimplex(uint8 Offset, float X, float Y) const
+{
+	using namespace HexNoise;
+
+	float T = (X + Y) * F2;
+	const int32 I = FastFloor(X + T);
+	const int32 J = FastFloor(Y + T);
+
+	T = (I + J) * G2;
+	const float X0 = X - (I - T);
+	const float Y0 = Y - (J - T);
+
+	const int32 I1 = X0 > Y0 ? 1 : 0;
+	const int32 J1 = 1 - I1;
+
+	const float X1 = X0 - I1 + G2;
+	const float Y1 = Y0 - J1 + G2;
+	const float X2 = X0 - 1 + 2 * G2;
+	const float Y2 = Y0 - 1 + 2 * G2;
+
+	const float N0 = Corner(X0, Y0, Index2D12(Offset, I, J));
+	const float N1 = Corner(X1, Y1, Index2D12(Offset, I + I1, J + J1));
+	const float N2 = Corner(X2, Y2, Index2D12(Offset, I + 1, J + 1));
+
+	return 50 * (N0 + N1 + N2);
+}
+
+VectorRegister4Float FHexSimplexNoise::SingleSimplex4(uint8 Offset, const VectorRegister4Float& X, const VectorRegister4Float& Y) const
+{
+	using namespace HexNoise;
+
+	const VectorRegister4Float One = VectorOneFloat();
+	const VectorRegister4Float VG2 = VectorSetFloat1(G2);
+	const VectorRegister4Float VTwoG2 = VectorSetFloat1(2 * G2);
+
+	VectorRegister4Float T = VectorMultiply(VectorAdd(X, Y), VectorSetFloat1(F2));
+	const VectorRegister4Float I = FastFloor4(VectorAdd(X, T));
+	const VectorRegister4Float J = FastFloor4(VectorAdd(Y, T));
+
+	T = VectorMultiply(VectorAdd(I, J), VG2);
+	const VectorRegister4Float X0 = VectorSubtract(X, VectorSubtract(I, T));
+	const VectorRegister4Float Y0 = VectorSubtract(Y, VectorSubtract(J, T));
+
+	// Lower triangle steps along X first, upper triangle along Y
+	const VectorRegister4Float I1 = VectorSelect(VectorCompareGT(X0, Y0), One, VectorZeroFloat());
+	const VectorRegister4Float J1 = VectorSubtract(One, I1);
+
+	const VectorRegister4Float X1 = VectorAdd(VectorSubtract(X0, I1), VG2);
+	const VectorRegister4Float Y1 = VectorAdd(VectorSubtract(Y0, J1), VG2);
+	const VectorRegister4Float X2 = VectorAdd(VectorSubtract(X0, One), VTwoG2);
+	const VectorRegister4Float Y2 = VectorAdd(VectorSubtract(Y0, One), VTwoG2);
+
+	// The permutation lookup is the only per-lane step, everything around it stays in registers
+	alignas(16) float LaneI[4], LaneJ[4], LaneI1[4];
+	VectorStoreAligned(I, LaneI);
+	VectorStoreAligned(J, LaneJ);
+	VectorStoreAligned(I1, LaneI1);
+
+	alignas(16) float G0X[4], G0Y[4], G1X[4], G1Y[4], G2X[4], G2Y[4];
+	for (int32 Lane = 0; Lane < 4; ++Lane)
+	{
+		const int32 LI = static_cast<int32>(LaneI[Lane]);
+		const int32 LJ = static_cast<int32>(LaneJ[Lane]);
+		const int32 LI1 = static_cast<int32>(LaneI1[Lane]);
+
+		const uint8 Grad0 = Index2D12(Offset, LI, LJ);
+		const uint8 Grad1 = Index2D12(Offset, LI + LI1, LJ + 1 - LI1);
+		const uint8 Grad2 = Index2D12(Offset, LI + 1, LJ + 1);
+
+		G0X[Lane] = GradX[Grad0];
+		G0Y[Lane] = GradY[Grad0];
+		G1X[Lane] = GradX[Grad1];
+		G1Y[Lane] = GradY[Grad1];
+		G2X[Lane] = GradX[Grad2];
+		G2Y[Lane] = GradY[Grad2];
+	}
+
+	const VectorRegister4Float N0 = Corner4(X0, Y0, VectorLoadAligned(G0X), VectorLoadAligned(G0Y));
+	const VectorRegister4Float N1 = Corner4(X1, Y1, VectorLoadAligned(G1X), VectorLoadAligned(G1Y));
+	const VectorRegister4Float N2 = Corner4(X2, Y2, VectorLoadAligned(G2X), VectorLoadAligned(G2Y));
+
+	return VectorMultiply(VectorSetFloat1(50.f), VectorAdd(VectorAdd(N0, N1), N2));
+}
+
+FHexNoiseGenerator::FHexNoiseGenerator(const FHexNoiseSettings& InSettings)
+	: Settings(InSettings)
+{
+	if (FHexSimplexNoise::SupportsSettings(Settings))
+	{
+		SimplexNoise.Emplace(Settings);
+		return;
+	}
+
+	// Same setup UFastNoiseWrapper::SetupFastNoise does, the plugin enums mirror FastNoise's
+	FastNoise& Noise = ScalarNoise.Emplace();
+	Noise.SetNoiseType(static_cast<FastNoise::NoiseType>(Settings.NoiseType));
+	Noise.SetSeed(Settings.Seed);
+	Noise.SetFrequency(Settings.Frequency);
+	Noise.SetInterp(static_cast<FastNoise::Interp>(Settings.Interp));
+	Noise.SetFractalType(static_cast<FastNoise::FractalType>(Settings.FractalType));
+	Noise.SetFractalOctaves(Settings.Octaves);
+	Noise.SetFractalLacunarity(Settings.Lacunarity);
+	Noise.SetFractalGain(Settings.Gain);
+	Noise.SetCellularJitter(Settings.CellularJitter);
+	Noise.SetCellularDistanceFunction(static_cast<FastNoise::CellularDistanceFunction>(Settings.CellularDistanceFunction));
+	Noise.SetCellularReturnType(static_cast<FastNoise::CellularReturnType>(Settings.CellularReturnType));
+}
+
+float FHexNoiseGenerator::GetNoise2D(float X, float Y) const
+{
+	return SimplexNoise ? SimplexNoise->GetNoise2D(X, Y) : ScalarNoise->GetNoise(X, Y);
+}
+
+void FHexNoiseGenerator::GetNoise2DBatch(TConstArrayView<float> X, TConstArrayView<float> Y, TArrayView<float> OutValues) const
+{
+	if (SimplexNoise)
+	{
+		SimplexNoise->GetNoise2DBatch(X, Y, OutValues);
+		return;
+	}
+
+	check(X.Num() == Y.Num() && OutValues.Num() >= X.Num());
+
+	for (int32 i = 0; i < X.Num(); ++i)
+	{
+		OutValues[i] = ScalarNoise->GetNoise(X[i], Y[i]);
+	}
+}
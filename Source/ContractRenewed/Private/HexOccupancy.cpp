@@ -0,0 +1,52 @@
+#include "HexOccupancy.h"
+
+void FHexOccupancy::Add(AActor* Actor, const FIntPoint& TileCoord)
+{
+	Tiles.FindOrAdd(TileCoord).AddUnique(Actor);
+}
+
+void FHexOccupancy::Remove(const AActor* Actor, const FIntPoint& TileCoord)
+{
+	FOccupants* Occupants = Tiles.Find(TileCoord);
+	if (!Occupants) return;
+
+	// Stale entries go too, so lists of tiles actors died on don't linger
+	Occupants->RemoveAllSwap([Actor](const TWeakObjectPtr<AActor>& Occupant)
+	{
+		return !Occupant.IsValid() || Occupant.Get() == Actor;
+	});
+
+	if (Occupants->IsEmpty())
+	{
+		Tiles.Remove(TileCoord);
+	}
+}
+
+void FHexOccupancy::Move(AActor* Actor, const FIntPoint& FromTile, const FIntPoint& ToTile)
+{
+	if (FromTile == ToTile) return;
+
+	Remove(Actor, FromTile);
+	Add(Actor, ToTile);
+}
+
+void FHexOccupancy::Reset()
+{
+	Tiles.Empty();
+}
+
+int32 FHexOccupancy::GetNumOccupants(const FIntPoint& TileCoord) const
+{
+	const FOccupants* Occupants = Tiles.Find(TileCoord);
+	return Occupants ? Occupants->Num() : 0;
+}
+
+SIZE_T FHexOccupancy::GetAllocatedSize() const
+{
+	SIZE_T Size = Tiles.GetAllocatedSize();
+	for (const TPair<FIntPoint, FOccupants>& Pair : Tiles)
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+	return Size;
+}
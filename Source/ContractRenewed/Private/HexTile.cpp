@@ -1,4 +1,5 @@
 #include "HexTile.h"
+#include "Components/StaticMeshComponent.h"
 
 AHexTile::AHexTile()
 {
@@ -11,3 +12,40 @@ void AHexTile::BeginPlay()
 {
 	Super::BeginPlay();
 }
+
+void AHexTile::SetupTile(const FIntPoint& InTileCoord, EHexTileType InTileType, UStaticMesh* Mesh, TConstArrayView<float> CustomData)
+{
+	TileIndex = InTileCoord;
+	TileType = InTileType;
+
+	if (TileMesh->GetStaticMesh() != Mesh)
+	{
+		TileMesh->SetStaticMesh(Mesh);
+	}
+
+	// The instance read these from per-instance custom data, the component gets them as custom primitive data
+	for (int32 i = 0; i < CustomData.Num(); ++i)
+	{
+		TileMesh->SetCustomPrimitiveDataFloat(i, CustomData[i]);
+	}
+}
+
+void AHexTile::ActivateTile()
+{
+	if (bTileActive) return;
+
+	bTileActive = true;
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	OnTilePromoted();
+}
+
+void AHexTile::DeactivateTile()
+{
+	if (!bTileActive) return;
+
+	bTileActive = false;
+	OnTileDemoted();
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+}
@@ -0,0 +1,348 @@
+#include "HexTileStore.h"
+
+namespace HexTileStore
+{
+	FORCEINLINE int32 FloorDiv(int32 Value, int32 Divisor)
+	{
+		return Value >= 0 ? Value / Divisor : (Value - Divisor + 1) / Divisor;
+	}
+}
+
+void FHexTileStore::Reset(int32 InChunkSize, float InHeightScale, TConstArrayView<FHexTileBiome> InBiomes)
+{
+	ChunkSize = FMath::Max(InChunkSize, 1);
+	HeightScale = FMath::Max(FMath::Abs(InHeightScale), UE_KINDA_SMALL_NUMBER);
+
+	ChunkSlots.Empty();
+	SlotChunkCoords.Empty();
+	FreeSlots.Empty();
+	SlotRevisions.Empty();
+	RemovedChunkRevision = ++Revision;
+	Heights.Empty();
+	Biomes.Empty();
+	InstanceIndices.Empty();
+	Flags.Empty();
+
+	// Tiles of a biome-less store still need a biome to read their type from
+	BiomeInfos = InBiomes;
+	if (BiomeInfos.IsEmpty())
+	{
+		BiomeInfos.AddDefaulted();
+	}
+
+	int32 NumMeshSlots = 0;
+	for (const FHexTileBiome& Biome : BiomeInfos)
+	{
+		NumMeshSlots = FMath::Max(NumMeshSlots, Biome.MeshSlot + 1);
+	}
+
+	InstanceTiles.Empty(NumMeshSlots);
+	InstanceTiles.SetNum(NumMeshSlots);
+	MeshSlotTops.Init(0.f, NumMeshSlots);
+}
+
+void FHexTileStore::SetWorldLayout(const FVector& InOrigin, const FHexSpacing& InSpacing, const FIntPoint& InAnchorTile)
+{
+	check(InAnchorTile == MakeAnchorTile(InAnchorTile));
+
+	Origin = InOrigin;
+	Spacing = InSpacing;
+	AnchorTile = InAnchorTile;
+}
+
+void FHexTileStore::SetMeshSlotTops(TConstArrayView<float> InMeshSlotTops)
+{
+	for (int32 MeshSlot = 0; MeshSlot < FMath::Min(MeshSlotTops.Num(), InMeshSlotTops.Num()); ++MeshSlot)
+	{
+		MeshSlotTops[MeshSlot] = InMeshSlotTops[MeshSlot];
+	}
+
+	// Every tile top may have moved
+	RemovedChunkRevision = ++Revision;
+	for (uint32& SlotRevision : SlotRevisions)
+	{
+		SlotRevision = Revision;
+	}
+}
+
+FIntPoint FHexTileStore::GetChunkCoord(const FIntPoint& TileCoord) const
+{
+	return FIntPoint(HexTileStore::FloorDiv(TileCoord.X, ChunkSize), HexTileStore::FloorDiv(TileCoord.Y, ChunkSize));
+}
+
+int32 FHexTileStore::GetLocalIndex(const FIntPoint& TileCoord) const
+{
+	const FIntPoint Local = TileCoord - GetChunkCoord(TileCoord) * ChunkSize;
+	return Local.Y * ChunkSize + Local.X;
+}
+
+FVector FHexTileStore::GetChunkLocalOrigin(const FIntPoint& ChunkCoord) const
+{
+	const FVector2D ChunkOrigin = FHexGridLayout::OffsetToWorld64(GetChunkOriginTile(ChunkCoord) - AnchorTile, Spacing);
+	return FVector(ChunkOrigin.X, ChunkOrigin.Y, 0.0);
+}
+
+int32 FHexTileStore::AddChunk(const FIntPoint& ChunkCoord)
+{
+	if (const int32* ExistingSlot = ChunkSlots.Find(ChunkCoord))
+		return *ExistingSlot * GetTilesPerChunk();
+
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop(EAllowShrinking::No);
+		SlotChunkCoords[Slot] = ChunkCoord;
+	}
+	else
+	{
+		Slot = SlotChunkCoords.Add(ChunkCoord);
+		SlotRevisions.Add(0);
+		const int32 NewNum = SlotChunkCoords.Num() * GetTilesPerChunk();
+		Heights.SetNumZeroed(NewNum);
+		Biomes.SetNumZeroed(NewNum);
+		InstanceIndices.SetNumUninitialized(NewNum);
+		Flags.SetNumZeroed(NewNum);
+	}
+
+	const int32 Base = Slot * GetTilesPerChunk();
+	for (int32 i = Base; i < Base + GetTilesPerChunk(); ++i)
+	{
+		Heights[i] = 0;
+		Biomes[i] = 0;
+		InstanceIndices[i] = INDEX_NONE;
+		Flags[i] = EHexTileFlags::None;
+	}
+
+	ChunkSlots.Add(ChunkCoord, Slot);
+	SlotRevisions[Slot] = ++Revision;
+	return Base;
+}
+
+bool FHexTileStore::RemoveChunk(const FIntPoint& ChunkCoord)
+{
+	int32 Slot;
+	if (!ChunkSlots.RemoveAndCopyValue(ChunkCoord, Slot))
+		return false;
+
+	// Clear the flags so stale indices held elsewhere read as invalid
+	const int32 Base = Slot * GetTilesPerChunk();
+	for (int32 i = Base; i < Base + GetTilesPerChunk(); ++i)
+	{
+		UnlinkInstance(i);
+		InstanceIndices[i] = INDEX_NONE;
+		Flags[i] = EHexTileFlags::None;
+	}
+
+	FreeSlots.Add(Slot);
+	RemovedChunkRevision = ++Revision;
+	return true;
+}
+
+void FHexTileStore::GetChunkCoords(TArray<FIntPoint>& OutChunkCoords) const
+{
+	ChunkSlots.GenerateKeyArray(OutChunkCoords);
+}
+
+int32 FHexTileStore::FindChunkBase(const FIntPoint& ChunkCoord) const
+{
+	const int32* Slot = ChunkSlots.Find(ChunkCoord);
+	return Slot ? *Slot * GetTilesPerChunk() : INDEX_NONE;
+}
+
+uint32 FHexTileStore::GetChunkRevision(const FIntPoint& ChunkCoord) const
+{
+	const int32* Slot = ChunkSlots.Find(ChunkCoord);
+	return Slot ? SlotRevisions[*Slot] : RemovedChunkRevision;
+}
+
+int32 FHexTileStore::FindTile(const FIntPoint& TileCoord) const
+{
+	const int32 Base = FindChunkBase(GetChunkCoord(TileCoord));
+	if (Base == INDEX_NONE)
+		return INDEX_NONE;
+
+	const int32 TileIndex = Base + GetLocalIndex(TileCoord);
+	return EnumHasAnyFlags(Flags[TileIndex], EHexTileFlags::Valid) ? TileIndex : INDEX_NONE;
+}
+
+int32 FHexTileStore::FindNeighbour(int32 TileIndex, int32 Direction) const
+{
+	const FIntPoint TileCoord = GetTileCoord(TileIndex);
+	const FIntPoint NeighbourCoord = GetNeighbourCoord(TileCoord, Direction);
+
+	// Most neighbours share the chunk, skip the chunk lookup for those
+	const int32 Local = TileIndex % GetTilesPerChunk();
+	const FIntPoint LocalCoord(Local % ChunkSize, Local / ChunkSize);
+	const FIntPoint NeighbourLocal = LocalCoord + (NeighbourCoord - TileCoord);
+	if (NeighbourLocal.X >= 0 && NeighbourLocal.Y >= 0 && NeighbourLocal.X < ChunkSize && NeighbourLocal.Y < ChunkSize)
+	{
+		const int32 NeighbourIndex = TileIndex - Local + NeighbourLocal.Y * ChunkSize + NeighbourLocal.X;
+		return EnumHasAnyFlags(Flags[NeighbourIndex], EHexTileFlags::Valid) ? NeighbourIndex : INDEX_NONE;
+	}
+
+	return FindTile(NeighbourCoord);
+}
+
+int32 FHexTileStore::FindTileAtLocation(const FVector& WorldLocation) const
+{
+	return FindTile(WorldToTileCoord(WorldLocation));
+}
+
+FIntPoint FHexTileStore::WorldToTileCoord(const FVector& WorldLocation) const
+{
+	const FVector LocalPos = WorldLocation - Origin;
+	return FHexGridLayout::WorldToOffsetPoint(LocalPos.X, LocalPos.Y, Spacing) + AnchorTile;
+}
+
+FIntPoint FHexTileStore::GetTileCoord(int32 TileIndex) const
+{
+	const int32 Slot = TileIndex / GetTilesPerChunk();
+	const int32 Local = TileIndex % GetTilesPerChunk();
+	return SlotChunkCoords[Slot] * ChunkSize + FIntPoint(Local % ChunkSize, Local / ChunkSize);
+}
+
+FIntPoint FHexTileStore::GetNeighbourCoord(const FIntPoint& TileCoord, int32 Direction)
+{
+	check(Direction >= 0 && Direction < NumDirections);
+	return FHexGridLayout::OffsetNeighbour(TileCoord, Direction);
+}
+
+FVector FHexTileStore::GetTileLocation(int32 TileIndex) const
+{
+	return Origin + GetTileLocalLocation(TileIndex);
+}
+
+FVector FHexTileStore::GetTileLocalLocation(int32 TileIndex) const
+{
+	return GetLocalLocation(GetTileCoord(TileIndex), GetHeight(TileIndex));
+}
+
+FVector FHexTileStore::GetLocalLocation(const FIntPoint& TileCoord, float Height) const
+{
+	const FVector2f TilePos = FHexGridLayout::OffsetToWorld(TileCoord - AnchorTile, Spacing);
+	return FVector(TilePos.X, TilePos.Y, Height);
+}
+
+int32 FHexTileStore::GetGroundHeights(TConstArrayView<FVector2D> Locations, TArrayView<float> OutHeights, TBitArray<>& InOutFound) const
+{
+	check(OutHeights.Num() >= Locations.Num() && InOutFound.Num() >= Locations.Num());
+
+	// Queries tend to come in runs over one chunk, the chunk lookup is reused until the chunk changes
+	bool bHasChunk = false;
+	FIntPoint LastChunkCoord = FIntPoint::ZeroValue;
+	int32 LastChunkBase = INDEX_NONE;
+
+	int32 NumFound = 0;
+	for (int32 i = 0; i < Locations.Num(); ++i)
+	{
+		if (InOutFound[i]) continue;
+
+		const FIntPoint TileCoord = WorldToTileCoord(FVector(Locations[i].X, Locations[i].Y, 0.0));
+		const FIntPoint ChunkCoord = GetChunkCoord(TileCoord);
+		if (!bHasChunk || ChunkCoord != LastChunkCoord)
+		{
+			bHasChunk = true;
+			LastChunkCoord = ChunkCoord;
+			LastChunkBase = FindChunkBase(ChunkCoord);
+		}
+
+		if (LastChunkBase == INDEX_NONE) continue;
+
+		const int32 TileIndex = LastChunkBase + GetLocalIndex(TileCoord);
+		if (!EnumHasAnyFlags(Flags[TileIndex], EHexTileFlags::Valid)) continue;
+
+		OutHeights[i] = GetGroundHeight(TileIndex);
+		InOutFound[i] = true;
+		++NumFound;
+	}
+	return NumFound;
+}
+
+void FHexTileStore::SetTile(int32 TileIndex, float Height, uint8 Biome, int32 InstanceIndex)
+{
+	check(BiomeInfos.IsValidIndex(Biome));
+	UnlinkInstance(TileIndex);
+
+	SetHeight(TileIndex, Height);
+	Biomes[TileIndex] = Biome;
+	InstanceIndices[TileIndex] = InstanceIndex;
+	EnumAddFlags(Flags[TileIndex], EHexTileFlags::Valid);
+	TouchChunk(TileIndex);
+
+	LinkInstance(TileIndex);
+}
+
+void FHexTileStore::SetBiome(int32 TileIndex, uint8 Biome)
+{
+	check(BiomeInfos.IsValidIndex(Biome));
+	UnlinkInstance(TileIndex);
+	Biomes[TileIndex] = Biome;
+	LinkInstance(TileIndex);
+	TouchChunk(TileIndex);
+}
+
+void FHexTileStore::SetInstanceIndex(int32 TileIndex, int32 InstanceIndex)
+{
+	UnlinkInstance(TileIndex);
+	InstanceIndices[TileIndex] = InstanceIndex;
+	LinkInstance(TileIndex);
+}
+
+void FHexTileStore::LinkInstance(int32 TileIndex)
+{
+	const int32 InstanceIndex = InstanceIndices[TileIndex];
+	if (InstanceIndex == INDEX_NONE || !EnumHasAnyFlags(Flags[TileIndex], EHexTileFlags::Valid))
+		return;
+
+	TArray<int32>& Owners = InstanceTiles[GetMeshSlot(TileIndex)];
+	if (InstanceIndex >= Owners.Num())
+	{
+		const int32 OldNum = Owners.Num();
+		Owners.SetNumUninitialized(InstanceIndex + 1);
+		for (int32 i = OldNum; i < Owners.Num(); ++i)
+		{
+			Owners[i] = INDEX_NONE;
+		}
+	}
+	Owners[InstanceIndex] = TileIndex;
+}
+
+void FHexTileStore::UnlinkInstance(int32 TileIndex)
+{
+	const int32 InstanceIndex = InstanceIndices[TileIndex];
+	if (InstanceIndex == INDEX_NONE || !EnumHasAnyFlags(Flags[TileIndex], EHexTileFlags::Valid))
+		return;
+
+	TArray<int32>& Owners = InstanceTiles[GetMeshSlot(TileIndex)];
+	if (Owners.IsValidIndex(InstanceIndex) && Owners[InstanceIndex] == TileIndex)
+	{
+		Owners[InstanceIndex] = INDEX_NONE;
+	}
+}
+
+void FHexTileStore::RemoveTile(int32 TileIndex)
+{
+	UnlinkInstance(TileIndex);
+	InstanceIndices[TileIndex] = INDEX_NONE;
+	Flags[TileIndex] = EHexTileFlags::None;
+	TouchChunk(TileIndex);
+}
+
+int16 FHexTileStore::QuantizeHeight(float Height) const
+{
+	const float Normalized = FMath::Clamp(Height / HeightScale, -1.f, 1.f);
+	return static_cast<int16>(FMath::RoundToInt32(Normalized * MAX_int16));
+}
+
+SIZE_T FHexTileStore::GetAllocatedSize() const
+{
+	SIZE_T Size = ChunkSlots.GetAllocatedSize() + SlotChunkCoords.GetAllocatedSize() + FreeSlots.GetAllocatedSize()
+		+ Heights.GetAllocatedSize() + Biomes.GetAllocatedSize() + InstanceIndices.GetAllocatedSize() + Flags.GetAllocatedSize()
+		+ SlotRevisions.GetAllocatedSize() + BiomeInfos.GetAllocatedSize() + MeshSlotTops.GetAllocatedSize() + InstanceTiles.GetAllocatedSize();
+
+	for (const TArray<int32>& Owners : InstanceTiles)
+	{
+		Size += Owners.GetAllocatedSize();
+	}
+	return Size;
+}
@@ -0,0 +1,92 @@
+#include "HexMinimap.h"
+#include "HexGridSettings.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HexMinimapTest
+{
+	FColor RandomColour(FRandomStream& Random)
+	{
+		return FColor(Random.RandRange(0, 255), Random.RandRange(0, 255), Random.RandRange(0, 255), 255);
+	}
+
+	// Blocks still dirty are drawn on the calling thread, so the picture is complete whichever path ran before
+	bool MatchesFullRaster(FHexMinimap& Minimap, TConstArrayView<FColor> TileColours)
+	{
+		Minimap.RasterizeNow();
+
+		const FHexMinimapLayout& Layout = Minimap.GetLayout();
+		const FIntPoint TextureSize = Layout.GetTextureSize();
+		TArray<FColor> Expected;
+		Expected.SetNumUninitialized(TextureSize.X * TextureSize.Y);
+		FHexMinimap::Rasterize(Layout, TileColours, FIntRect(FIntPoint::ZeroValue, TextureSize), Expected);
+
+		const TConstArrayView<FColor> Pixels = Minimap.GetPixels();
+		return Pixels.Num() == Expected.Num() && FMemory::Memcmp(Pixels.GetData(), Expected.GetData(), Expected.Num() * sizeof(FColor)) == 0;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexMinimapParityTest, "ContractRenewed.HexGrid.MinimapParity",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Redrawing only the blocks under edited tiles has to give the picture a full raster of the final colours gives
+bool FHexMinimapParityTest::RunTest(const FString& Parameters)
+{
+	using namespace HexMinimapTest;
+
+	constexpr int32 GridSize = 96;
+	constexpr int32 NumEdits = 64;
+
+	for (const float PixelsPerTile : { 1.f, 4.f, 7.5f })
+	{
+		FHexMinimapLayout Layout;
+		Layout.MinTile = FIntPoint(-40, 18);
+		Layout.NumTiles = FIntPoint(GridSize, GridSize);
+		Layout.Spacing = GetDefault<UHexGridSettings>()->GetSpacing();
+		Layout.PixelsPerTile = PixelsPerTile;
+
+		FHexMinimap Minimap;
+		Minimap.SetLayout(Layout);
+		const FIntPoint MinTile = Minimap.GetLayout().MinTile;
+
+		FRandomStream Random(GridSize);
+		TArray<FColor> TileColours;
+		TileColours.SetNumUninitialized(GridSize * GridSize);
+		for (int32 i = 0; i < TileColours.Num(); ++i)
+		{
+			TileColours[i] = RandomColour(Random);
+			Minimap.SetTileColour(MinTile + FIntPoint(i % GridSize, i / GridSize), TileColours[i]);
+		}
+
+		auto EditTiles = [&]()
+		{
+			for (int32 i = 0; i < NumEdits; ++i)
+			{
+				const FIntPoint Local(Random.RandRange(0, GridSize - 1), Random.RandRange(0, GridSize - 1));
+				TileColours[Local.Y * GridSize + Local.X] = RandomColour(Random);
+				Minimap.SetTileColour(MinTile + Local, TileColours[Local.Y * GridSize + Local.X]);
+			}
+		};
+
+		const FString What = FString::Printf(TEXT("%.1f pixels per tile"), PixelsPerTile);
+		TestTrue(What + TEXT(", full raster"), MatchesFullRaster(Minimap, TileColours));
+
+		EditTiles();
+		TestTrue(What + TEXT(", incremental raster"), MatchesFullRaster(Minimap, TileColours));
+
+		// Edits landing while a worker rasterizes go to a copy of the colours and are drawn by the next raster
+		EditTiles();
+		TestTrue(What + TEXT(", raster launched"), Minimap.LaunchRaster());
+		EditTiles();
+		while (!Minimap.FinishRaster(nullptr))
+		{
+			FPlatformProcess::Sleep(0.f);
+		}
+		TestTrue(What + TEXT(", edits during a worker raster"), MatchesFullRaster(Minimap, TileColours));
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#include "HexNoise.h"
+#include "HexGridSettings.h"
+#include "HexLayout.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexNoiseParityTest, "ContractRenewed.HexGrid.NoiseParity",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// The batch path stands in for UFastNoiseWrapper during generation, so it has to give the wrapper's values
+bool FHexNoiseParityTest::RunTest(const FString& Parameters)
+{
+	// Not a multiple of four, so the scalar tail after the last full vector is covered too
+	constexpr int32 Width = 97;
+	constexpr int32 NumTiles = Width * Width;
+	constexpr float Tolerance = 1e-4f;
+
+	// Tiles straddle the origin so negative coordinates wrap the permutation tables like far chunks do
+	const FHexSpacing Spacing = GetDefault<UHexGridSettings>()->GetSpacing();
+	TArray<float> X, Y;
+	for (int32 i = 0; i < NumTiles; ++i)
+	{
+		const FVector2f TilePos = FHexGridLayout::OffsetToWorld(FHexOffset(i % Width - Width / 2, i / Width - Width / 2), Spacing);
+		X.Add(TilePos.X);
+		Y.Add(TilePos.Y);
+	}
+
+	UFastNoiseWrapper* NoiseWrapper = NewObject<UFastNoiseWrapper>(GetTransientPackage());
+
+	for (const EFastNoise_NoiseType NoiseType : { EFastNoise_NoiseType::Simplex, EFastNoise_NoiseType::SimplexFractal })
+	{
+		for (const int32 Seed : { 1337, -7, 90210 })
+		{
+			FHexNoiseSettings NoiseSettings;
+			NoiseSettings.NoiseType = NoiseType;
+			NoiseSettings.Seed = Seed;
+			NoiseSettings.Octaves = 4;
+
+			NoiseWrapper->SetupFastNoise(
+				NoiseSettings.NoiseType, NoiseSettings.Seed, NoiseSettings.Frequency, NoiseSettings.Interp,
+				NoiseSettings.FractalType, NoiseSettings.Octaves, NoiseSettings.Lacunarity, NoiseSettings.Gain,
+				NoiseSettings.CellularJitter, NoiseSettings.CellularDistanceFunction, NoiseSettings.CellularReturnType);
+
+			const FHexNoiseGenerator Generator(NoiseSettings);
+			TestTrue(FString::Printf(TEXT("%s is vectorized"), *UEnum::GetValueAsString(NoiseType)), Generator.IsVectorized());
+
+			TArray<float> Batched;
+			Batched.SetNumUninitialized(NumTiles);
+			Generator.GetNoise2DBatch(X, Y, Batched);
+
+			float MaxBatchError = 0.f;
+			float MaxSingleError = 0.f;
+			for (int32 i = 0; i < NumTiles; ++i)
+			{
+				const float Reference = NoiseWrapper->GetNoise2D(X[i], Y[i]);
+				MaxBatchError = FMath::Max(MaxBatchError, FMath::Abs(Batched[i] - Reference));
+				MaxSingleError = FMath::Max(MaxSingleError, FMath::Abs(Generator.GetNoise2D(X[i], Y[i]) - Reference));
+			}
+
+			const FString What = FString::Printf(TEXT("%s seed %d"), *UEnum::GetValueAsString(NoiseType), Seed);
+			TestTrue(FString::Printf(TEXT("%s batch max error %g"), *What, MaxBatchError), MaxBatchError <= Tolerance);
+			TestTrue(FString::Printf(TEXT("%s single max error %g"), *What, MaxSingleError), MaxSingleError <= Tolerance);
+		}
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include "HexManager.h"
+#include "HexGridSettings.h"
+#include "Async/ParallelFor.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHexSpawnPlanDeterminismTest, "ContractRenewed.HexGrid.SpawnPlanDeterminism",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+// Plans have to depend on the seed, the spawnables and the set of tiles only, not on tile order or the planning thread
+bool FHexSpawnPlanDeterminismTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 GridSize = 64;
+	constexpr int32 NumRuns = 8;
+	constexpr int32 GridSeed = 1337;
+
+	const FHexSpacing Spacing = GetDefault<UHexGridSettings>()->GetSpacing();
+	TArray<FVector> TilePositions;
+	TArray<FIntPoint> TileCoords;
+	for (int32 y = 0; y < GridSize; ++y)
+	{
+		for (int32 x = 0; x < GridSize; ++x)
+		{
+			const FVector2f TilePos = FHexGridLayout::OffsetToWorld(FHexOffset(x, y), Spacing);
+			TilePositions.Add(FVector(TilePos.X, TilePos.Y, (x * 7 + y * 3) % 11 * 10.f));
+			TileCoords.Add(FIntPoint(x, y));
+		}
+	}
+
+	TArray<FSpawnableData> Spawnables;
+	FSpawnableData& Enemies = Spawnables.AddDefaulted_GetRef();
+	Enemies.ActorClass = APawn::StaticClass();
+	Enemies.SpawnAmount = 40;
+	FSpawnableData& Pickups = Spawnables.AddDefaulted_GetRef();
+	Pickups.ActorClass = AActor::StaticClass();
+	Pickups.SpawnAmount = 60;
+	Pickups.bAllowStacking = true;
+	Pickups.StackChance = 0.5f;
+
+	auto PlanHash = [&Spawnables](int32 Seed, const TArray<FVector>& Positions, const TArray<FIntPoint>& Coords)
+	{
+		TArray<FHexSpawnPlanEntry> SpawnPlan;
+		AHexManager::BuildSpawnPlan(Seed, Spawnables, Positions, Coords, SpawnPlan);
+		return AHexManager::HashSpawnPlan(SpawnPlan);
+	};
+
+	TArray<FHexSpawnPlanEntry> SpawnPlan;
+	AHexManager::BuildSpawnPlan(GridSeed, Spawnables, TilePositions, TileCoords, SpawnPlan);
+	TestEqual(TEXT("Every spawn is planned"), SpawnPlan.Num(), Enemies.SpawnAmount + Pickups.SpawnAmount);
+
+	const uint64 ExpectedHash = AHexManager::HashSpawnPlan(SpawnPlan);
+	TestTrue(TEXT("Second serial run"), PlanHash(GridSeed, TilePositions, TileCoords) == ExpectedHash);
+	TestTrue(TEXT("Another seed gives another plan"), PlanHash(GridSeed + 1, TilePositions, TileCoords) != ExpectedHash);
+
+	// Every run shuffles the tile list its own way, the way another chunk load order would, and they all plan at once
+	TArray<uint64> Hashes;
+	Hashes.SetNumZeroed(NumRuns);
+	ParallelFor(NumRuns, [&](int32 Run)
+	{
+		TArray<FVector> RunPositions = TilePositions;
+		TArray<FIntPoint> RunCoords = TileCoords;
+		FRandomStream Shuffle(Run);
+		for (int32 i = RunCoords.Num() - 1; i > 0; --i)
+		{
+			const int32 j = Shuffle.RandRange(0, i);
+			RunPositions.Swap(i, j);
+			RunCoords.Swap(i, j);
+		}
+		Hashes[Run] = PlanHash(GridSeed, RunPositions, RunCoords);
+	});
+
+	for (int32 Run = 0; Run < NumRuns; ++Run)
+	{
+		TestTrue(FString::Printf(TEXT("Parallel shuffled run %d"), Run), Hashes[Run] == ExpectedHash);
+	}
+
+	return true;
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include "AbilitySystemInterface.h"
 #include "GameplayEffectTypes.h"
 #include "PaperCharacter.h"
+#include "Perception/AISightTargetInterface.h"
 #include "HopperBaseCharacter.generated.h"
 
 class UHopperGameplayAbility;
@@ -21,7 +22,7 @@ class USphereComponent;
  */
 UCLASS()
 class CONTRACTRENEWED_API AHopperBaseCharacter : public APaperCharacter, public IAbilitySystemInterface,
-                                        public IHopperCharacterInterface
+                                        public IHopperCharacterInterface, public IAISightTargetInterface
 {
 	GENERATED_BODY()
 
@@ -40,16 +41,48 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual float GetMaxHealth() const;
 
+	/** Returns the offset coordinate of the hex tile under the character, false if no grid tile is loaded there */
+	UFUNCTION(BlueprintCallable)
+	bool GetCurrentTile(FIntPoint& OutTile) const;
+
+	/** Returns the tile the character last landed on, false if the last landing wasn't on the grid */
+	UFUNCTION(BlueprintCallable)
+	bool GetLandedTile(FIntPoint& OutTile) const;
+
 		
 	UPROPERTY(EditAnywhere, BlueprintReadWrite,  Category = "Abilities")
 	bool bCanPunchToken = false;
 
+	/**
+	 * Sight perception checks from observers on the same hex grid as this character walk the tile tops between them
+	 * instead of tracing against collision. While both stand on the ground the result is served from the grid's
+	 * tile to tile line of sight cache, mid-jump the walk uses their actual locations.
+	 * Only tiles hide the character then, props, walls and other pawns no longer block sight. Off by default
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool bUseHexGridLineOfSight = false;
+
+	/**
+	 * Files the character under the hex it stands on in the grid's occupancy registry whenever it steps onto another,
+	 * so AI and other neighbourhood queries walk a few tiles instead of overlapping physics. Punches keep using the
+	 * attack sphere overlap, which also hits actors that never register.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI")
+	bool bUseHexGridOccupancy = true;
+
+	virtual UAISense_Sight::EVisibilityResult CanBeSeenFrom(const FCanBeSeenFromContext& Context, FVector& OutSeenLocation,
+	                                                       int32& OutNumberOfLoSChecksPerformed,
+	                                                       int32& OutNumberOfAsyncLosCheckRequested,
+	                                                       float& OutSightStrength, int32* UserData = nullptr,
+	                                                       const FOnPendingVisibilityQueryProcessedDelegate* Delegate = nullptr) override;
+
 protected:
 	/**********************************
 	 *         Class Overrides
 	 **********************************/
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void OnJumped_Implementation() override;
 	virtual void Landed(const FHitResult& Hit) override;
 	virtual void NotifyJumpApex() override;
@@ -216,6 +249,13 @@ protected:
 	 */
 	virtual void SetCurrentAnimationDirection(const FVector& Velocity, TOptional<FMinimalViewInfo> ViewInfo);
 
+	/**
+	 * Moves the character to another tile of the grid occupancy registry once it may have left its hex. Bound to
+	 * OnCharacterMovementUpdated, which costs a distance check while the character stays clear of its hex's edges.
+	 */
+	UFUNCTION()
+	void UpdateOccupiedTile(float DeltaTime, FVector OldLocation, const FVector OldVelocity);
+
 	/**************************/
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Config")
@@ -248,6 +288,17 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Config")
 	uint8 bFootstepGate:1;
 
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config")
+	FIntPoint LandedTile{INDEX_NONE, INDEX_NONE};
+
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Config")
+	uint8 bHasLandedTile:1;
+
+	// Centre of the tile the character is registered on and the squared radius of the circle inside its hex,
+	// negative while it isn't on a grid so every movement update looks again
+	FVector2D OccupiedTileCentre = FVector2D::ZeroVector;
+	double OccupiedTileInnerRadiusSquared = -1.0;
+
 	FTimerHandle AttackTimer;
 	FTimerHandle FootstepTimer;
 	FTimerHandle JumpReset;
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "HexTile.h"
+#include "HexBiomeTable.generated.h"
+
+class UStaticMesh;
+
+// Per-instance custom data written for every tile, the tile materials read these through PerInstanceCustomData
+namespace HexBiomeCustomData
+{
+	constexpr int32 ColourR = 0;
+	constexpr int32 ColourG = 1;
+	constexpr int32 ColourB = 2;
+	constexpr int32 Wetness = 3;
+	constexpr int32 Highlight = 4;
+	constexpr int32 Fog = 5;		// 0 unexplored, 0.5 explored, 1 in sight
+	constexpr int32 Num = 6;
+}
+
+// Height and moisture ranges of a biome, inclusive and in raw noise units (-1 to 1, before HeightStrength)
+struct FHexBiomeThresholds
+{
+	float MinHeight = -1.f;
+	float MaxHeight = 1.f;
+	float MinMoisture = -1.f;
+	float MaxMoisture = 1.f;
+
+	bool Contains(float Height, float Moisture) const
+	{
+		return Height >= MinHeight && Height <= MaxHeight && Moisture >= MinMoisture && Moisture <= MaxMoisture;
+	}
+
+	bool UsesMoisture() const { return MinMoisture > -1.f || MaxMoisture < 1.f; }
+};
+
+/** One row of a biome table, tiles take the first row whose ranges contain their height and moisture */
+USTRUCT(BlueprintType)
+struct FHexBiome
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome")
+	FName Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome")
+	EHexTileType TileType = EHexTileType::GRASS;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome|Thresholds", meta = (ClampMin = "-1.0", ClampMax = "1.0"))
+	float MinHeight = -1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome|Thresholds", meta = (ClampMin = "-1.0", ClampMax = "1.0"))
+	float MaxHeight = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome|Thresholds", meta = (ClampMin = "-1.0", ClampMax = "1.0"))
+	float MinMoisture = -1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome|Thresholds", meta = (ClampMin = "-1.0", ClampMax = "1.0"))
+	float MaxMoisture = 1.f;
+
+	// Biomes sharing a mesh are drawn by the same HISM and told apart by their custom data
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome|Visuals")
+	UStaticMesh* Mesh = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome|Visuals")
+	FLinearColor Colour = FLinearColor::White;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biome|Visuals", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Wetness = 0.f;
+
+	FHexBiomeThresholds GetThresholds() const { return { MinHeight, MaxHeight, MinMoisture, MaxMoisture }; }
+
+	/** Writes the custom data floats for a tile of this biome, OutCustomData holds HexBiomeCustomData::Num entries */
+	void GetCustomData(float Highlight, float Fog, TArrayView<float> OutCustomData) const;
+};
+
+/**
+ * Maps noise height and moisture to tile types and their look.
+ * Moisture is a second noise layer using the grid's noise settings with the overrides below,
+ * it is only sampled when at least one biome narrows its moisture range.
+ */
+UCLASS(BlueprintType)
+class CONTRACTRENEWED_API UHexBiomeTable : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Checked in order, the last row also catches tiles no row contains
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Biomes")
+	TArray<FHexBiome> Biomes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Moisture")
+	int32 MoistureSeedOffset = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Moisture")
+	float MoistureFrequency = 0.005f;
+
+	/** Index of the biome a tile with Height and Moisture falls in, 0 for an empty table */
+	static uint8 Classify(TConstArrayView<FHexBiomeThresholds> Thresholds, float Height, float Moisture);
+};
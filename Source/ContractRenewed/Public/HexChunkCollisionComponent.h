@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "Interfaces/Interface_CollisionDataProvider.h"
+#include "HexChunkSurface.h"
+#include "HexChunkCollisionComponent.generated.h"
+
+class UBodySetup;
+
+UENUM(BlueprintType)
+enum class EHexCollisionMode : uint8
+{
+	PerInstance,	// Every HISM instance carries its own body, the original setup
+	ChunkTriMesh,	// One triangle mesh per chunk, hex tops plus the walls between height steps
+	ChunkConvex,	// One body per chunk holding a convex hex prism per tile
+};
+
+/**
+ * Merged collision for one chunk of a hex grid, replacing the per-instance bodies of the grid HISMs.
+ * Has no render proxy, it only exists to put a single body per chunk into the physics scene.
+ */
+UCLASS(ClassGroup = (HexGrid))
+class CONTRACTRENEWED_API UHexChunkCollisionComponent : public UPrimitiveComponent, public IInterface_CollisionDataProvider
+{
+	GENERATED_BODY()
+
+public:
+	UHexChunkCollisionComponent();
+
+	/** Rebuilds the collision from the valid tiles of a chunk, Extents are indexed by mesh slot */
+	void Build(const FHexChunkTiles& Tiles, TConstArrayView<FHexTileExtent> Extents, EHexCollisionMode Mode);
+
+	/** Drops the geometry and the physics state, the component can be built again for another chunk */
+	void ClearCollision();
+
+	/** Shapes the physics scene holds for this chunk, one per tile for convex collision */
+	int32 GetNumShapes() const;
+	int32 GetNumTriangles() const { return Surface.GetNumTriangles(); }
+
+	//~ Begin UPrimitiveComponent Interface
+	virtual UBodySetup* GetBodySetup() override { return BodySetup; }
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	//~ End UPrimitiveComponent Interface
+
+	//~ Begin IInterface_CollisionDataProvider Interface
+	virtual bool GetPhysicsTriMeshData(FTriMeshCollisionData* CollisionData, bool InUseAllTriData) override;
+	virtual bool ContainsPhysicsTriMeshData(bool InUseAllTriData) const override { return Surface.Indices.Num() > 0; }
+	virtual bool WantsNegXTriMesh() override { return false; }
+	//~ End IInterface_CollisionDataProvider Interface
+
+private:
+	UPROPERTY(Transient)
+	UBodySetup* BodySetup = nullptr;
+
+	// Tri mesh geometry, empty for convex collision
+	FHexChunkSurface Surface;
+
+	FBox LocalBounds = FBox(ForceInit);
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexLayout.h"
+
+class FHexTileStore;
+struct FMeshDescription;
+
+// Vertical reach of a mesh slot's tile mesh around the tile height, taken from the mesh bounds
+struct FHexTileExtent
+{
+	float Top = 0.f;
+	float Bottom = -100.f;
+
+	float GetTop(float Height) const { return Height + Top; }
+	float GetBottom(float Height) const { return Height + FMath::Min(Bottom, Top - 1.f); }
+};
+
+// One chunk's tiles copied out of the tile store, so its surface can be built off the game thread
+struct CONTRACTRENEWED_API FHexChunkTiles
+{
+	FIntPoint ChunkCoord = FIntPoint::ZeroValue;
+	int32 ChunkSize = 0;
+	FHexSpacing Spacing;
+
+	// See FHexTileStore::GetChunkOriginTile, whatever is built from the tiles goes at its local origin
+	FIntPoint OriginTile = FIntPoint::ZeroValue;
+
+	// Indexed by local tile index, Centres are relative to OriginTile with Z at the tile height
+	TArray<FVector3f> Centres;
+	TArray<uint8> Biomes;
+	TArray<uint8> MeshSlots;
+	TBitArray<> Valid;
+
+	/** Copies a loaded chunk, false if the store doesn't have it */
+	bool Read(const FHexTileStore& TileStore, const FIntPoint& InChunkCoord);
+};
+
+/**
+ * Triangles over the tops of a chunk's tiles, plus walls where the ground steps down. Walls towards other chunks
+ * always reach the tile bottom, so neighbours streaming in or out never leave a gap. Triangles face outwards.
+ */
+struct CONTRACTRENEWED_API FHexChunkSurface
+{
+	static constexpr int32 NumCorners = 6;
+
+	TArray<FVector3f> Positions;
+
+	// Biome of the tile each vertex belongs to
+	TArray<uint8> VertexBiomes;
+
+	// Three per triangle
+	TArray<int32> Indices;
+
+	FBox3f Bounds = FBox3f(ForceInit);
+
+	void Build(const FHexChunkTiles& Tiles, TConstArrayView<FHexTileExtent> Extents);
+	int32 GetNumTriangles() const { return Indices.Num() / 3; }
+	void Reset();
+
+	/** Flat shaded static mesh data, one polygon group named ProxyMaterialSlot and the biome colour in the vertex colour */
+	void ToMeshDescription(TConstArrayView<FLinearColor> BiomeColours, FMeshDescription& OutMeshDescription) const;
+
+	/** Corners of a pointy hex around its centre, corner K sits at 60K - 30 degrees so edge K (corners K, K + 1) faces 60K degrees */
+	static void GetCorners(const FHexSpacing& Spacing, FVector2f OutCorners[NumCorners]);
+
+	static const FName ProxyMaterialSlot;
+
+private:
+	void AddTriangle(int32 A, int32 B, int32 C, const FVector3f& Facing);
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexLayout.h"
+
+class FHexTileStore;
+
+enum class EHexFogState : uint8
+{
+	Unexplored,
+	Explored,	// Seen before, not in sight now
+	Visible,
+};
+
+/**
+ * Fog of war for one grid: the tiles each player has explored and currently sees, as packed bits in 16 x 16 tile pages
+ * keyed by tile coordinate, so explored ground outlives the chunks it was seen on.
+ * A viewer only recomputes its field of view after crossing into another tile or when a chunk in its sight changes,
+ * and only the tiles whose state flipped are queued for consumers. Game thread only.
+ */
+class CONTRACTRENEWED_API FHexFogOfWar
+{
+public:
+	/** Registers a viewer for PlayerId, nothing is seen until its first UpdateViewer */
+	int32 AddViewer(int32 PlayerId, int32 SightRadius, float EyeHeight);
+
+	/** Drops a viewer, tiles only it saw fall back to explored */
+	void RemoveViewer(int32 ViewerId);
+
+	/** Moves a viewer, returns true when that made it recompute its field of view */
+	bool UpdateViewer(int32 ViewerId, const FHexTileStore& TileStore, const FVector& WorldLocation);
+
+	/** Forgets every viewer and everything any player has explored */
+	void Reset();
+
+	EHexFogState GetTileState(int32 PlayerId, const FIntPoint& TileCoord) const;
+	bool IsTileVisible(int32 PlayerId, const FIntPoint& TileCoord) const { return GetTileState(PlayerId, TileCoord) == EHexFogState::Visible; }
+	bool IsTileExplored(int32 PlayerId, const FIntPoint& TileCoord) const { return GetTileState(PlayerId, TileCoord) != EHexFogState::Unexplored; }
+
+	/** True if any player currently sees the tile */
+	bool IsTileVisibleToAny(const FIntPoint& TileCoord) const;
+
+	void GetPlayerIds(TArray<int32>& OutPlayerIds) const;
+
+	/** Moves the tiles whose state changed for PlayerId since the last call into OutTiles, each tile once */
+	void ConsumeChangedTiles(int32 PlayerId, TArray<FIntPoint>& OutTiles);
+
+	SIZE_T GetAllocatedSize() const;
+
+	/**
+	 * Tiles within SightRadius of CentreTile whose tops an eye EyeHeight above the centre tile can see. Rings are swept
+	 * outwards carrying the steepest slope to a tile top seen so far along each line, so a tile is shadowed when a nearer
+	 * tile on its way to the centre rises above it. Horizons is scratch space, kept by callers to avoid reallocating.
+	 */
+	static void ComputeFieldOfView(const FHexTileStore& TileStore, const FIntPoint& CentreTile, int32 SightRadius, float EyeHeight,
+		TArray<FIntPoint>& OutTiles, TArray<float>& Horizons);
+
+private:
+	static constexpr int32 PageShift = 4;
+	static constexpr int32 PageSize = 1 << PageShift;
+	static constexpr int32 TilesPerPage = PageSize * PageSize;
+	static constexpr int32 WordsPerPage = TilesPerPage / 64;
+
+	struct FPage
+	{
+		uint64 Explored[WordsPerPage] = {};
+		uint64 Visible[WordsPerPage] = {};
+
+		// Set while the tile sits in the player's ChangedTiles
+		uint64 Changed[WordsPerPage] = {};
+
+		// Viewers of the player seeing each tile, Visible mirrors which are non-zero
+		uint8 ViewerCounts[TilesPerPage] = {};
+	};
+
+	struct FPlayer
+	{
+		TMap<FIntPoint, FPage> Pages;
+		TArray<FIntPoint> ChangedTiles;
+	};
+
+	struct FViewer
+	{
+		int32 PlayerId = INDEX_NONE;
+		int32 SightRadius = 0;
+		float EyeHeight = 0.f;
+
+		bool bHasTile = false;
+		FIntPoint Tile = FIntPoint::ZeroValue;
+
+		// Store revision the field of view was computed at
+		uint32 Revision = 0;
+
+		TArray<FIntPoint> VisibleTiles;
+	};
+
+	static FIntPoint GetPageCoord(const FIntPoint& TileCoord) { return FIntPoint(TileCoord.X >> PageShift, TileCoord.Y >> PageShift); }
+	static int32 GetPageIndex(const FIntPoint& TileCoord) { return (TileCoord.X & (PageSize - 1)) + (TileCoord.Y & (PageSize - 1)) * PageSize; }
+	static bool GetBit(const uint64* Words, int32 Index) { return (Words[Index >> 6] >> (Index & 63)) & 1; }
+	static void SetBit(uint64* Words, int32 Index, bool bValue);
+
+	static bool IsViewCurrent(const FHexTileStore& TileStore, FViewer& Viewer);
+	void AddVisibleTile(FPlayer& Player, const FIntPoint& TileCoord);
+	void RemoveVisibleTile(FPlayer& Player, const FIntPoint& TileCoord);
+	void MarkChanged(FPlayer& Player, FPage& Page, const FIntPoint& TileCoord, int32 Index);
+
+	TSparseArray<FViewer> Viewers;
+	TMap<int32, FPlayer> Players;
+
+	// Scratch reused by every field of view computation
+	TArray<FIntPoint> NewVisibleTiles;
+	TArray<float> Horizons;
+};
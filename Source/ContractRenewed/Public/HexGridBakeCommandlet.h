@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "HexGridBakeCommandlet.generated.h"
+
+/**
+ * Bakes every non-streaming AHexManager in the given maps and saves them, so the levels ship with their grid.
+ * Usage: UnrealEditor-Cmd ContractRenewed.uproject -run=HexGridBake [-Maps=/Game/Maps/Easy+/Game/Maps/Hard]
+ * Without -Maps the Easy, Hard and Level1 maps are baked.
+ */
+UCLASS()
+class CONTRACTRENEWED_API UHexGridBakeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UHexGridBakeCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
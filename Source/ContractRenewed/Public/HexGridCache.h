@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexManager.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Generated grid cached on disk under Saved/HexGridCache, one file per set of generation inputs. Files are kept
+ * least recently used first up to MaxFiles and MaxBytes, so scrubbing seeds doesn't grow the directory without end.
+ * The file is memory-mapped and chunks are copied straight out of it, so a hit never touches the noise.
+ * Native endianness, the cache is a local build artifact and isn't meant to be shipped between platforms.
+ *
+ * Layout: FFileHeader, NumChunks x FFileChunk, then NumTiles entries of each tile array in order:
+ * TileCoords (FIntPoint), LocalPositions (FVector3f), Heights (float), Biomes (uint8).
+ */
+class CONTRACTRENEWED_API FHexGridCache
+{
+public:
+	// Bump whenever generation output or the file layout changes, old files are then ignored
+	static constexpr uint32 Version = 2;
+
+	static constexpr int32 MaxFiles = 16;
+	static constexpr int64 MaxBytes = 256ll * 1024 * 1024;
+
+	FHexGridCache();
+	~FHexGridCache();
+
+	/** Hash of everything that shapes the generated tiles */
+	static uint64 MakeKey(const FHexNoiseSettings& NoiseSettings, const FHexGenerationInputs& Inputs);
+	static FString GetCachePath(uint64 Key);
+
+	/** Maps the cache file at Path, false when it is missing, truncated or was written for another key or version */
+	bool Open(const FString& Path, uint64 Key);
+
+	/** Copies a cached chunk into OutChunk, false if the cache doesn't hold it */
+	bool ReadChunk(const FIntPoint& ChunkCoord, FHexChunkBuffer& OutChunk) const;
+
+	/**
+	 * Writes every chunk in ChunkBuffers to Path, then evicts the least recently used files past the limits.
+	 * Goes through a temporary file of its own, so readers never map a partial cache and concurrent writers don't collide
+	 */
+	static bool Write(const FString& Path, uint64 Key, int32 ChunkSize, const TArray<FHexChunkBuffer>& ChunkBuffers);
+
+private:
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint64 Key;
+		int32 ChunkSize;
+		int32 NumChunks;
+		int32 NumTiles;
+		int32 Padding;
+	};
+
+	struct FFileChunk
+	{
+		FIntPoint ChunkCoord;
+		int32 FirstTile;
+		int32 NumTiles;
+	};
+
+	static constexpr uint32 Magic = 0x47584548; // "HEXG"
+
+	static int64 GetFileSize(int32 NumChunks, int32 NumTiles);
+
+	/** Deletes the oldest cache files in Directory past MaxFiles or MaxBytes, KeepPath always stays */
+	static void Evict(const FString& Directory, const FString& KeepPath);
+
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	const FFileHeader* Header = nullptr;
+	const FIntPoint* TileCoords = nullptr;
+	const FVector3f* LocalPositions = nullptr;
+	const float* Heights = nullptr;
+	const uint8* Biomes = nullptr;
+
+	TMap<FIntPoint, FFileChunk> Chunks;
+};
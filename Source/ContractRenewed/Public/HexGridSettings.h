@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
+#include "HexLayout.h"
 #include "HexGridSettings.generated.h"
 
 UCLASS(Config = HexGridSettings, defaultconfig, meta = (DisplayName = "Hex Grid Settings"))
@@ -13,9 +14,15 @@ public:
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HexGrid|Layout")
 	float TileHorizontalOffset = 86.602539f;
 
-	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HexGrid|Layout")
+	// Always half of TileHorizontalOffset for a hex grid, FHexGridLayout derives it from the spacing and ignores this.
+	// Only still read from config so a tuned value gets reported instead of silently changing the layout
+	UPROPERTY(Config, meta = (DeprecatedProperty, DeprecationMessage = "Odd rows are always shifted by half of TileHorizontalOffset"))
 	float OddRowHorizontalOffset = 43.30127f;
 
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "HexGrid|Layout")
 	float TileVerticalOffset = 75.0f;
+
+	FHexSpacing GetSpacing() const { return FHexSpacing(TileHorizontalOffset, TileVerticalOffset); }
+
+	virtual void PostInitProperties() override;
 };
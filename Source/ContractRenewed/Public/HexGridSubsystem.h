@@ -3,15 +3,161 @@
 #include "CoreMinimal.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Subsystems/WorldSubsystem.h"
-#include "FastNoiseWrapper.h"
+#include "HexNoise.h"
+#include "HexTileStore.h"
+#include "HexLineOfSight.h"
+#include "HexFogOfWar.h"
+#include "HexInfluenceMap.h"
+#include "HexOccupancy.h"
 #include "HexGridSubsystem.generated.h"
 
+// A tile on one of the registered grids, only valid until that grid's chunk is released or regenerated
+struct FHexTileRef
+{
+	const AActor* Grid = nullptr;
+	const FHexTileStore* Store = nullptr;
+	int32 TileIndex = INDEX_NONE;
+
+	bool IsValid() const { return Store && Store->IsValidTile(TileIndex); }
+	FIntPoint GetCoord() const { return Store->GetTileCoord(TileIndex); }
+};
+
 UCLASS()
 class CONTRACTRENEWED_API UHexGridSubsystem : public UWorldSubsystem
 {
 	GENERATED_BODY()
 
 public:
-	void Initialize(FSubsystemCollectionBase& Collection) override;
-	UFastNoiseWrapper* NoiseWrapperLvl1;
+	/**
+	 * Shared generator for NoiseSettings, built on first request and reused by every grid asking for the same settings.
+	 * Safe to call and to sample from any thread, workers that sample heavily should take their own copy.
+	 */
+	TSharedRef<const FHexNoiseGenerator> GetNoiseGenerator(const FHexNoiseSettings& NoiseSettings);
+
+	/**
+	 * Samples noise at every (X[i], Y[i]) into OutHeights[i], from any thread.
+	 * Simplex and FBM simplex run four lanes at a time, other noise types one sample at a time.
+	 */
+	void SampleNoise2D(const FHexNoiseSettings& NoiseSettings, TConstArrayView<float> X, TConstArrayView<float> Y, TArrayView<float> OutHeights);
+
+	/** Tile store owned on behalf of a grid actor, created on first use */
+	FHexTileStore& GetTileStore(const AActor* Grid);
+	const FHexTileStore* FindTileStore(const AActor* Grid) const;
+	void RemoveTileStore(const AActor* Grid);
+
+	/** Fog of war kept for a grid actor next to its tile store, created on first use and dropped with the store */
+	FHexFogOfWar& GetFogOfWar(const AActor* Grid);
+	const FHexFogOfWar* FindFogOfWar(const AActor* Grid) const;
+
+	/** Influence layers kept for a grid actor, created on first use and dropped with the store */
+	FHexInfluenceMap& GetInfluenceMap(const AActor* Grid);
+	const FHexInfluenceMap* FindInfluenceMap(const AActor* Grid) const;
+
+	/** Actors registered on a grid actor's tiles, null until something stands on the grid */
+	const FHexOccupancy* FindOccupancy(const AActor* Grid) const;
+
+	/**
+	 * Files Actor under the tile at Location, moving it off its previous tile or grid, and returns that tile. Off the
+	 * loaded grid the actor is removed. Meant to be called once a mover may have left its hex, not every frame
+	 */
+	FHexTileRef UpdateOccupant(AActor* Actor, const FVector& Location);
+	void RemoveOccupant(const AActor* Actor);
+
+	/** Lets hits on Component resolve to tiles, its instances draw the tiles of MeshSlot in Grid's store */
+	void RegisterInstanceComponent(const AActor* Grid, const UPrimitiveComponent* Component, uint8 MeshSlot);
+
+	/** Tile under WorldLocation on any grid, found by hex rounding rather than a trace */
+	FHexTileRef FindTileAtLocation(const FVector& WorldLocation) const;
+
+	/** Tile drawn by the HISM instance a trace or sweep hit, invalid if the hit wasn't a grid instance */
+	FHexTileRef FindTileFromHit(const FHitResult& Hit) const;
+
+	/** World Z of the tile top under (X, Y) on any grid, read from the tile data instead of traced. False off the loaded grid */
+	UFUNCTION(BlueprintPure, Category = "HexGrid")
+	bool GetGroundHeightAt(double X, double Y, float& OutHeight) const;
+
+	/**
+	 * GetGroundHeightAt for many locations at once, OutHeights[i] gets DefaultHeight where no grid has a tile.
+	 * Returns how many locations were on a grid. Game thread only, workers can query an FHexTileStore directly.
+	 */
+	int32 GetGroundHeights(TConstArrayView<FVector2D> Locations, TArrayView<float> OutHeights, float DefaultHeight = 0.f) const;
+
+	/** True when no tile top on any grid rises above the segment, walked hex by hex instead of traced against collision */
+	UFUNCTION(BlueprintPure, Category = "HexGrid")
+	bool HasLineOfSight(const FVector& From, const FVector& To) const;
+
+	/**
+	 * Line of sight between the tiles under From and To, with eyes EyeHeight above their tops. Results are cached per
+	 * grid until a chunk under the line changes. Ends on different grids or off the grid fall back to HasLineOfSight.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "HexGrid")
+	bool HasTileLineOfSight(const FVector& From, const FVector& To, float EyeHeight = 100.f);
+
+	/** Fog of war state of the tile under Location for a player, by PlayerState player id. False off the grid */
+	UFUNCTION(BlueprintPure, Category = "HexGrid|FogOfWar")
+	bool IsLocationVisibleToPlayer(const FVector& Location, int32 PlayerId) const;
+
+	UFUNCTION(BlueprintPure, Category = "HexGrid|FogOfWar")
+	bool IsLocationExploredByPlayer(const FVector& Location, int32 PlayerId) const;
+
+	/**
+	 * True if some player sees the tile under Location, or the location is on no grid with fog of war. AI off every
+	 * player's screen can use it to skip work nobody would notice.
+	 */
+	UFUNCTION(BlueprintPure, Category = "HexGrid|FogOfWar")
+	bool IsLocationRelevantToPlayers(const FVector& Location) const;
+
+	/** Value of an influence layer on the tile under Location, 0 where no grid keeps influence */
+	UFUNCTION(BlueprintPure, Category = "HexGrid|Influence")
+	float SampleInfluence(EHexInfluenceLayer Layer, const FVector& Location) const;
+
+	/** SampleInfluence for many agents at once, without resolving the tiles themselves. Game thread */
+	void SampleInfluences(EHexInfluenceLayer Layer, TConstArrayView<FVector> Locations, TArrayView<float> OutValues) const;
+
+	/** Adds Amount to the tile under Location in the next influence step, for sources the grid doesn't know about */
+	UFUNCTION(BlueprintCallable, Category = "HexGrid|Influence")
+	void AddInfluence(EHexInfluenceLayer Layer, const FVector& Location, float Amount);
+
+	/**
+	 * Top of the tile within Radius of Location with the highest value of a layer, or the lowest with bLowest.
+	 * Lets AI head for pickups or away from threat from one shared map. False off the grid
+	 */
+	UFUNCTION(BlueprintCallable, Category = "HexGrid|Influence")
+	bool FindInfluencePeak(EHexInfluenceLayer Layer, const FVector& Location, int32 Radius, bool bLowest, FVector& OutLocation) const;
+
+	/**
+	 * Registered actors within Radius of Location, found by walking the tiles in reach instead of an overlap.
+	 * False when Location isn't on a grid anything stands on, callers fall back to physics then
+	 */
+	UFUNCTION(BlueprintCallable, Category = "HexGrid|Occupancy")
+	bool FindOccupantsInRadius(const FVector& Location, float Radius, TArray<AActor*>& OutActors) const;
+
+	/** Registered actors on the tiles within TileRadius steps of the tile under Location, 0 for that tile alone */
+	UFUNCTION(BlueprintCallable, Category = "HexGrid|Occupancy")
+	bool FindOccupantsInTileRange(const FVector& Location, int32 TileRadius, TArray<AActor*>& OutActors) const;
+
+private:
+	struct FOccupantInfo
+	{
+		TObjectKey<AActor> Grid;
+		FIntPoint Tile = FIntPoint::ZeroValue;
+	};
+
+	struct FInstanceComponentInfo
+	{
+		TObjectKey<AActor> Grid;
+		uint8 MeshSlot = 0;
+	};
+
+	// Generators are immutable, the lock only guards the map itself
+	FCriticalSection NoiseGeneratorsLock;
+	TMap<FHexNoiseSettings, TSharedRef<const FHexNoiseGenerator>> NoiseGenerators;
+
+	TMap<TObjectKey<AActor>, TUniquePtr<FHexTileStore>> TileStores;
+	TMap<TObjectKey<AActor>, FHexLineOfSightCache> LineOfSightCaches;
+	TMap<TObjectKey<AActor>, TUniquePtr<FHexFogOfWar>> FogOfWars;
+	TMap<TObjectKey<AActor>, TUniquePtr<FHexInfluenceMap>> InfluenceMaps;
+	TMap<TObjectKey<AActor>, FHexOccupancy> Occupancies;
+	TMap<TObjectKey<AActor>, FOccupantInfo> Occupants;
+	TMap<TObjectKey<UPrimitiveComponent>, FInstanceComponentInfo> InstanceComponents;
 };
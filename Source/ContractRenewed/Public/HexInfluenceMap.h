@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tasks/Task.h"
+#include "HexInfluenceMap.generated.h"
+
+class FHexTileStore;
+
+UENUM(BlueprintType)
+enum class EHexInfluenceLayer : uint8
+{
+	PlayerThreat,	// Spreads from player pawns
+	EnemyDensity,	// Spreads from enemies
+	PickupValue,	// Spreads from pickups
+
+	Num UMETA(Hidden)
+};
+
+USTRUCT(BlueprintType)
+struct FHexInfluenceLayerSettings
+{
+	GENERATED_BODY()
+
+	// Share of a tile's value that evens out with its neighbours each step, higher reaches further faster
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Influence", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Spread = 0.5f;
+
+	// Kept each step, the rest fades. A source settles at roughly Strength / (1 - Decay) on its own tile
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Influence", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Decay = 0.9f;
+
+	// Added on a source's tile every step
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Influence")
+	float SourceStrength = 1.f;
+
+	// Spawned actors with this tag are sources of the layer, player pawns always feed the threat layer
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Influence")
+	FName SourceTag;
+};
+
+/**
+ * Per-tile float layers over a rectangular window of a grid's offset coordinates, spread by repeated diffusion steps
+ * instead of being recomputed from scratch. Each step reads one buffer and writes the other on worker threads, four
+ * tiles at a time, while the game thread keeps sampling the last finished step and queueing sources for the next.
+ * Missing tiles hold nothing and pass nothing on, so influence flows around holes and off the loaded ground.
+ */
+class CONTRACTRENEWED_API FHexInfluenceMap
+{
+public:
+	static constexpr int32 NumLayers = static_cast<int32>(EHexInfluenceLayer::Num);
+
+	~FHexInfluenceMap();
+
+	/** Moves the window onto Size tiles from MinTile, values inside both windows are kept. Waits for a running step */
+	void SetWindow(const FIntPoint& InMinTile, const FIntPoint& InSize);
+	const FIntPoint& GetMinTile() const { return MinTile; }
+	const FIntPoint& GetSize() const { return Size; }
+	bool IsInWindow(const FIntPoint& TileCoord) const;
+
+	void SetLayerSettings(EHexInfluenceLayer Layer, const FHexInfluenceLayerSettings& InSettings);
+
+	/** Queued for the next launched step. Game thread */
+	void AddSource(EHexInfluenceLayer Layer, const FIntPoint& TileCoord, float Amount);
+
+	/** Value of the last finished step, 0 outside the window. Game thread, or any thread while no step runs */
+	float Sample(EHexInfluenceLayer Layer, const FIntPoint& TileCoord) const;
+
+	/**
+	 * Starts one diffusion step of every layer on worker threads, rereading which tiles exist when the store changed.
+	 * Does nothing while the previous step hasn't been collected by FinishStep
+	 */
+	bool LaunchStep(const FHexTileStore& TileStore);
+
+	/** Makes a completed step the one samples read, true if there was one. Game thread */
+	bool FinishStep();
+
+	bool IsStepRunning() const { return StepTask.IsValid(); }
+	void WaitForStep();
+
+	uint64 GetNumSteps() const { return NumSteps; }
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	int32 GetCellIndex(const FIntPoint& TileCoord) const;
+	void UpdatePassable(const FHexTileStore& TileStore);
+
+	// Worker side, writes Next from Current for rows [FirstRow, LastRow) of one layer
+	void DiffuseRows(int32 Layer, int32 FirstRow, int32 LastRow);
+
+	FIntPoint MinTile = FIntPoint::ZeroValue;
+	FIntPoint Size = FIntPoint::ZeroValue;
+
+	// Rows carry a zero cell either side and the window a zero row above and below, so neighbour reads never need bounds checks
+	int32 Stride = 0;
+	int32 CellsPerLayer = 0;
+
+	FHexInfluenceLayerSettings Settings[NumLayers];
+
+	// Copied from Settings when a step launches, the only settings workers read
+	FHexInfluenceLayerSettings StepSettings[NumLayers];
+
+	// NumLayers * CellsPerLayer each, Current is what samples read
+	TArray<float> Current;
+	TArray<float> Next;
+	TArray<float> Sources;
+	TArray<float> PendingSources;
+
+	// 1 where the store has a tile, 0 elsewhere. Rebuilt when the store revision moves
+	TArray<float> Passable;
+	uint32 PassableRevision = 0;
+	bool bPassableValid = false;
+
+	UE::Tasks::FTask StepTask;
+	uint64 NumSteps = 0;
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexLayout.h"
+#include "HexTileStore.h"
+
+/*
+ * Hex area walks that keep their whole state inline, so they allocate nothing and can run on any thread.
+ * The coordinate iterators yield axial coordinates whether or not a tile exists there, THexTileIterator
+ * wraps one of them to visit only the tiles a store has loaded.
+ *
+ *   for (FHexTileRangeIterator It(TileStore, TileCoord, 3); It; ++It) { It.GetTileIndex(); }
+ */
+
+/** Every hex within Radius steps of Centre, Centre included, column by column in axial space */
+class FHexRangeIterator
+{
+public:
+	FHexRangeIterator(const FHexAxial& InCentre, int32 InRadius)
+		: Centre(InCentre), Radius(InRadius), Q(-InRadius)
+	{
+		BeginColumn();
+	}
+
+	explicit operator bool() const { return Q <= Radius; }
+	FHexAxial operator*() const { return Centre + FHexAxial(Q, R); }
+
+	FHexRangeIterator& operator++()
+	{
+		if (++R > MaxR)
+		{
+			++Q;
+			BeginColumn();
+		}
+		return *this;
+	}
+
+	int32 GetRadius() const { return Radius; }
+
+private:
+	void BeginColumn()
+	{
+		R = FMath::Max(-Radius, -Q - Radius);
+		MaxR = FMath::Min(Radius, -Q + Radius);
+	}
+
+	FHexAxial Centre;
+	int32 Radius;
+	int32 Q;
+	int32 R = 0;
+	int32 MaxR = 0;
+};
+
+/** The 6 * Radius hexes exactly Radius steps from Centre, or Centre alone for radius 0 */
+class FHexRingIterator
+{
+public:
+	FHexRingIterator(const FHexAxial& Centre, int32 InRadius)
+		: Current(Centre + HexLayout::Directions[4] * InRadius), Radius(InRadius), Side(InRadius < 0 ? HexLayout::NumDirections : 0)
+	{
+	}
+
+	explicit operator bool() const { return Side < HexLayout::NumDirections; }
+	FHexAxial operator*() const { return Current; }
+
+	FHexRingIterator& operator++()
+	{
+		if (Radius == 0)
+		{
+			Side = HexLayout::NumDirections;
+			return *this;
+		}
+
+		// Walks each side starting from the corner in direction 4, side K heading along direction K
+		Current = HexLayout::Neighbour(Current, Side);
+		if (++Step == Radius)
+		{
+			Step = 0;
+			++Side;
+		}
+		return *this;
+	}
+
+	int32 GetRadius() const { return Radius; }
+
+private:
+	FHexAxial Current;
+	int32 Radius;
+	int32 Side;
+	int32 Step = 0;
+};
+
+/** Rings 0 to MaxRadius one after another, so hexes come closest first */
+class FHexSpiralIterator
+{
+public:
+	FHexSpiralIterator(const FHexAxial& InCentre, int32 InMaxRadius)
+		: Centre(InCentre), MaxRadius(InMaxRadius), Ring(InCentre, InMaxRadius < 0 ? -1 : 0)
+	{
+	}
+
+	explicit operator bool() const { return static_cast<bool>(Ring); }
+	FHexAxial operator*() const { return *Ring; }
+
+	FHexSpiralIterator& operator++()
+	{
+		++Ring;
+		if (!Ring && Ring.GetRadius() < MaxRadius)
+		{
+			Ring = FHexRingIterator(Centre, Ring.GetRadius() + 1);
+		}
+		return *this;
+	}
+
+	/** Distance of the current hex from the centre */
+	int32 GetRadius() const { return Ring.GetRadius(); }
+
+private:
+	FHexAxial Centre;
+	int32 MaxRadius;
+	FHexRingIterator Ring;
+};
+
+/** The hexes a straight line from From to To passes through, both ends included, one per step of distance */
+class FHexLineIterator
+{
+public:
+	FHexLineIterator(const FHexAxial& InFrom, const FHexAxial& To)
+		: From(InFrom), Delta(To - InFrom), NumSteps(HexLayout::Distance(InFrom, To))
+	{
+	}
+
+	explicit operator bool() const { return Step <= NumSteps; }
+
+	FHexAxial operator*() const
+	{
+		// Interpolated relative to From so far coordinates keep float precision, the nudge settles lines running along hex edges the same way every time
+		const float Alpha = NumSteps > 0 ? static_cast<float>(Step) / NumSteps : 0.f;
+		return From + HexLayout::Round(Delta.Q * Alpha + 1e-6f, Delta.R * Alpha + 2e-6f);
+	}
+
+	FHexLineIterator& operator++()
+	{
+		++Step;
+		return *this;
+	}
+
+	int32 GetStep() const { return Step; }
+	int32 GetNumSteps() const { return NumSteps; }
+
+private:
+	FHexAxial From;
+	FHexAxial Delta;
+	int32 NumSteps;
+	int32 Step = 0;
+};
+
+/**
+ * Runs a coordinate iterator over the grid's offset coordinates and stops only on tiles the store has,
+ * which clips the walk to the grid bounds and the loaded chunks. Same thread rules as reading the store.
+ */
+template <typename CoordIteratorType>
+class THexTileIterator
+{
+public:
+	/** Takes the coordinate iterator's arguments, with hexes given as offset tile coordinates */
+	template <typename... ArgTypes>
+	explicit THexTileIterator(const FHexTileStore& InTileStore, const ArgTypes&... Args)
+		: TileStore(InTileStore), CoordIt(ToCoordArg(Args)...)
+	{
+		SkipMissingTiles();
+	}
+
+	explicit operator bool() const { return TileIndex != INDEX_NONE; }
+
+	THexTileIterator& operator++()
+	{
+		++CoordIt;
+		SkipMissingTiles();
+		return *this;
+	}
+
+	int32 GetTileIndex() const { return TileIndex; }
+	const FIntPoint& GetTileCoord() const { return TileCoord; }
+	const CoordIteratorType& GetCoordIterator() const { return CoordIt; }
+
+private:
+	static FHexAxial ToCoordArg(const FIntPoint& Coord) { return FHexGridLayout::OffsetToAxial(FHexOffset(Coord)); }
+	static const FHexAxial& ToCoordArg(const FHexAxial& Axial) { return Axial; }
+	static int32 ToCoordArg(int32 Value) { return Value; }
+
+	void SkipMissingTiles()
+	{
+		for (; CoordIt; ++CoordIt)
+		{
+			TileCoord = FHexGridLayout::AxialToOffset(*CoordIt).ToIntPoint();
+
+			// Walks stay inside one chunk for long stretches, the chunk lookup is only redone when they leave it
+			const FIntPoint ChunkCoord = TileStore.GetChunkCoord(TileCoord);
+			if (!bHasChunk || ChunkCoord != LastChunkCoord)
+			{
+				bHasChunk = true;
+				LastChunkCoord = ChunkCoord;
+				LastChunkBase = TileStore.FindChunkBase(ChunkCoord);
+			}
+
+			if (LastChunkBase == INDEX_NONE) continue;
+
+			TileIndex = LastChunkBase + TileStore.GetLocalIndex(TileCoord);
+			if (TileStore.IsValidTile(TileIndex)) return;
+		}
+
+		TileIndex = INDEX_NONE;
+	}
+
+	const FHexTileStore& TileStore;
+	CoordIteratorType CoordIt;
+
+	FIntPoint TileCoord = FIntPoint::ZeroValue;
+	int32 TileIndex = INDEX_NONE;
+
+	bool bHasChunk = false;
+	FIntPoint LastChunkCoord = FIntPoint::ZeroValue;
+	int32 LastChunkBase = INDEX_NONE;
+};
+
+using FHexTileRangeIterator = THexTileIterator<FHexRangeIterator>;
+using FHexTileRingIterator = THexTileIterator<FHexRingIterator>;
+using FHexTileSpiralIterator = THexTileIterator<FHexSpiralIterator>;
+using FHexTileLineIterator = THexTileIterator<FHexLineIterator>;
@@ -0,0 +1,256 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EHexOrientation : uint8
+{
+	Pointy,	// Rows of hexes, every other row shifted half a tile along X
+	Flat,	// Columns of hexes, every other column shifted half a tile along Y
+};
+
+enum class EHexOffsetParity : uint8
+{
+	Odd,	// Odd rows (pointy) or columns (flat) are shoved forward
+	Even,	// Even rows or columns are shoved forward
+};
+
+// Offset coordinates as the grid stores them, Col runs along X and Row along Y
+struct FHexOffset
+{
+	int32 Col = 0;
+	int32 Row = 0;
+
+	constexpr FHexOffset() = default;
+	constexpr FHexOffset(int32 InCol, int32 InRow) : Col(InCol), Row(InRow) {}
+	explicit FHexOffset(const FIntPoint& Point) : Col(Point.X), Row(Point.Y) {}
+
+	FIntPoint ToIntPoint() const { return FIntPoint(Col, Row); }
+	constexpr bool operator==(const FHexOffset& Other) const { return Col == Other.Col && Row == Other.Row; }
+	constexpr bool operator!=(const FHexOffset& Other) const { return !(*this == Other); }
+};
+
+struct FHexAxial
+{
+	int32 Q = 0;
+	int32 R = 0;
+
+	constexpr FHexAxial() = default;
+	constexpr FHexAxial(int32 InQ, int32 InR) : Q(InQ), R(InR) {}
+
+	constexpr FHexAxial operator+(const FHexAxial& Other) const { return FHexAxial(Q + Other.Q, R + Other.R); }
+	constexpr FHexAxial operator-(const FHexAxial& Other) const { return FHexAxial(Q - Other.Q, R - Other.R); }
+	constexpr FHexAxial operator*(int32 Scale) const { return FHexAxial(Q * Scale, R * Scale); }
+	constexpr bool operator==(const FHexAxial& Other) const { return Q == Other.Q && R == Other.R; }
+	constexpr bool operator!=(const FHexAxial& Other) const { return !(*this == Other); }
+};
+
+struct FHexCube
+{
+	int32 Q = 0;
+	int32 R = 0;
+	int32 S = 0;
+
+	constexpr FHexCube() = default;
+	constexpr FHexCube(int32 InQ, int32 InR, int32 InS) : Q(InQ), R(InR), S(InS) {}
+	constexpr bool operator==(const FHexCube& Other) const { return Q == Other.Q && R == Other.R && S == Other.S; }
+};
+
+// Centre to centre distances, Column along the axis the hexes line up on and Row across it
+struct FHexSpacing
+{
+	float Column = 1.f;
+	float Row = 1.f;
+
+	constexpr FHexSpacing() = default;
+	constexpr FHexSpacing(float InColumn, float InRow) : Column(InColumn), Row(InRow) {}
+};
+
+namespace HexLayout
+{
+	constexpr int32 NumDirections = 6;
+
+	// Neighbour steps in axial space, starting at +Q and turning towards -R
+	constexpr FHexAxial Directions[NumDirections] =
+	{
+		FHexAxial(1, 0), FHexAxial(1, -1), FHexAxial(0, -1), FHexAxial(-1, 0), FHexAxial(-1, 1), FHexAxial(0, 1),
+	};
+
+	constexpr int32 Abs(int32 Value) { return Value < 0 ? -Value : Value; }
+	constexpr float Abs(float Value) { return Value < 0.f ? -Value : Value; }
+	constexpr int32 Max(int32 A, int32 B) { return A > B ? A : B; }
+
+	constexpr int32 FloorToInt(float Value)
+	{
+		const int32 Truncated = static_cast<int32>(Value);
+		return Truncated - (Value < static_cast<float>(Truncated) ? 1 : 0);
+	}
+
+	constexpr int32 RoundToInt(float Value) { return FloorToInt(Value + 0.5f); }
+
+	// Value / 2 rounded towards negative infinity, exact because callers only pass even numbers
+	constexpr int32 HalfOfEven(int32 Value) { return Value >> 1; }
+
+	constexpr FHexCube AxialToCube(const FHexAxial& Axial) { return FHexCube(Axial.Q, Axial.R, -Axial.Q - Axial.R); }
+	constexpr FHexAxial CubeToAxial(const FHexCube& Cube) { return FHexAxial(Cube.Q, Cube.R); }
+
+	/** Snaps fractional axial coordinates to the hex containing them */
+	constexpr FHexAxial Round(float Q, float R)
+	{
+		const float S = -Q - R;
+		int32 RoundedQ = RoundToInt(Q);
+		int32 RoundedR = RoundToInt(R);
+		const int32 RoundedS = RoundToInt(S);
+
+		// Rebuild whichever component drifted the most from the other two
+		const float DiffQ = Abs(RoundedQ - Q);
+		const float DiffR = Abs(RoundedR - R);
+		const float DiffS = Abs(RoundedS - S);
+
+		const bool bFixQ = DiffQ > DiffR && DiffQ > DiffS;
+		const bool bFixR = !bFixQ && DiffR > DiffS;
+		RoundedQ = bFixQ ? -RoundedR - RoundedS : RoundedQ;
+		RoundedR = bFixR ? -RoundedQ - RoundedS : RoundedR;
+		return FHexAxial(RoundedQ, RoundedR);
+	}
+
+	constexpr int32 Distance(const FHexAxial& A, const FHexAxial& B)
+	{
+		const FHexAxial Delta = A - B;
+		return (Abs(Delta.Q) + Abs(Delta.R) + Abs(Delta.Q + Delta.R)) / 2;
+	}
+
+	constexpr FHexAxial Neighbour(const FHexAxial& Axial, int32 Direction) { return Axial + Directions[Direction]; }
+}
+
+/**
+ * Hex coordinate conversions for one orientation and offset parity, picked at compile time so every
+ * conversion folds down to a few integer ops or multiply-adds without branching on the layout.
+ * World positions are relative to the centre of tile (0, 0) and only cover the grid plane, Z is up to the caller.
+ */
+template <EHexOrientation Orientation, EHexOffsetParity Parity>
+struct THexLayout
+{
+	static constexpr bool bPointy = Orientation == EHexOrientation::Pointy;
+	static constexpr int32 ParitySign = Parity == EHexOffsetParity::Odd ? -1 : 1;
+
+	static constexpr FHexAxial OffsetToAxial(const FHexOffset& Offset)
+	{
+		if constexpr (bPointy)
+		{
+			return FHexAxial(Offset.Col - HexLayout::HalfOfEven(Offset.Row + ParitySign * (Offset.Row & 1)), Offset.Row);
+		}
+		else
+		{
+			return FHexAxial(Offset.Col, Offset.Row - HexLayout::HalfOfEven(Offset.Col + ParitySign * (Offset.Col & 1)));
+		}
+	}
+
+	static constexpr FHexOffset AxialToOffset(const FHexAxial& Axial)
+	{
+		if constexpr (bPointy)
+		{
+			return FHexOffset(Axial.Q + HexLayout::HalfOfEven(Axial.R + ParitySign * (Axial.R & 1)), Axial.R);
+		}
+		else
+		{
+			return FHexOffset(Axial.Q, Axial.R + HexLayout::HalfOfEven(Axial.Q + ParitySign * (Axial.Q & 1)));
+		}
+	}
+
+	static constexpr FHexCube OffsetToCube(const FHexOffset& Offset) { return HexLayout::AxialToCube(OffsetToAxial(Offset)); }
+	static constexpr FHexOffset CubeToOffset(const FHexCube& Cube) { return AxialToOffset(HexLayout::CubeToAxial(Cube)); }
+
+	static constexpr FVector2f AxialToWorld(const FHexAxial& Axial, const FHexSpacing& Spacing)
+	{
+		if constexpr (bPointy)
+		{
+			return FVector2f((Axial.Q + Axial.R * 0.5f) * Spacing.Column, Axial.R * Spacing.Row);
+		}
+		else
+		{
+			return FVector2f(Axial.Q * Spacing.Column, (Axial.R + Axial.Q * 0.5f) * Spacing.Row);
+		}
+	}
+
+	// Offset to world directly, the half tile shift is the low bit of the row (or column) so this stays branch free
+	static constexpr FVector2f OffsetToWorld(const FHexOffset& Offset, const FHexSpacing& Spacing)
+	{
+		if constexpr (bPointy)
+		{
+			return FVector2f((Offset.Col - ParitySign * 0.5f * (Offset.Row & 1)) * Spacing.Column, Offset.Row * Spacing.Row);
+		}
+		else
+		{
+			return FVector2f(Offset.Col * Spacing.Column, (Offset.Row - ParitySign * 0.5f * (Offset.Col & 1)) * Spacing.Row);
+		}
+	}
+
+	static constexpr FHexAxial WorldToAxial(float X, float Y, const FHexSpacing& Spacing)
+	{
+		if constexpr (bPointy)
+		{
+			const float R = Y / Spacing.Row;
+			return HexLayout::Round(X / Spacing.Column - R * 0.5f, R);
+		}
+		else
+		{
+			const float Q = X / Spacing.Column;
+			return HexLayout::Round(Q, Y / Spacing.Row - Q * 0.5f);
+		}
+	}
+
+	static constexpr FHexOffset WorldToOffset(float X, float Y, const FHexSpacing& Spacing)
+	{
+		return AxialToOffset(WorldToAxial(X, Y, Spacing));
+	}
+
+	static constexpr FHexOffset OffsetNeighbour(const FHexOffset& Offset, int32 Direction)
+	{
+		return AxialToOffset(HexLayout::Neighbour(OffsetToAxial(Offset), Direction));
+	}
+
+	static constexpr int32 OffsetDistance(const FHexOffset& A, const FHexOffset& B)
+	{
+		return HexLayout::Distance(OffsetToAxial(A), OffsetToAxial(B));
+	}
+
+	// FIntPoint convenience overloads, X is the column and Y the row
+
+	static FORCEINLINE FVector2f OffsetToWorld(const FIntPoint& Offset, const FHexSpacing& Spacing)
+	{
+		return OffsetToWorld(FHexOffset(Offset), Spacing);
+	}
+
+	// Double precision version for coordinates far from tile (0, 0), where float positions can't resolve a tile anymore
+	static FORCEINLINE FVector2D OffsetToWorld64(const FIntPoint& Offset, const FHexSpacing& Spacing)
+	{
+		if constexpr (bPointy)
+		{
+			return FVector2D((Offset.X - ParitySign * 0.5 * (Offset.Y & 1)) * Spacing.Column, static_cast<double>(Offset.Y) * Spacing.Row);
+		}
+		else
+		{
+			return FVector2D(static_cast<double>(Offset.X) * Spacing.Column, (Offset.Y - ParitySign * 0.5 * (Offset.X & 1)) * Spacing.Row);
+		}
+	}
+
+	static FORCEINLINE FIntPoint WorldToOffsetPoint(float X, float Y, const FHexSpacing& Spacing)
+	{
+		return WorldToOffset(X, Y, Spacing).ToIntPoint();
+	}
+
+	static FORCEINLINE FIntPoint OffsetNeighbour(const FIntPoint& Offset, int32 Direction)
+	{
+		return OffsetNeighbour(FHexOffset(Offset), Direction).ToIntPoint();
+	}
+};
+
+// The layout the game's grid uses, pointy hexes with odd rows shifted half a tile along +X
+using FHexGridLayout = THexLayout<EHexOrientation::Pointy, EHexOffsetParity::Odd>;
+
+static_assert(FHexGridLayout::OffsetToAxial(FHexOffset(0, 1)) == FHexAxial(0, 1));
+static_assert(FHexGridLayout::OffsetToAxial(FHexOffset(3, -3)) == FHexAxial(5, -3));
+static_assert(FHexGridLayout::AxialToOffset(FHexGridLayout::OffsetToAxial(FHexOffset(-7, -5))) == FHexOffset(-7, -5));
+static_assert(FHexGridLayout::OffsetNeighbour(FHexOffset(0, 0), 1) == FHexOffset(0, -1));
+static_assert(FHexGridLayout::OffsetNeighbour(FHexOffset(0, 1), 1) == FHexOffset(1, 0));
+static_assert(FHexGridLayout::WorldToOffset(130.f, 75.f, FHexSpacing(86.602539f, 75.f)) == FHexOffset(1, 1));
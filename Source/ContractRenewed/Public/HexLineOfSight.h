@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexLayout.h"
+
+class FHexTileStore;
+
+/**
+ * Hex DDA over a grid's layout: visits every hex a segment crosses on the grid plane, in order, whether or not
+ * the store has a tile there. Each step leaves through the nearest of the hex edges the segment heads towards,
+ * so corners and edges are resolved exactly instead of sampled. Allocates nothing.
+ */
+class CONTRACTRENEWED_API FHexLineWalker
+{
+public:
+	FHexLineWalker(const FHexTileStore& TileStore, const FVector& InStart, const FVector& InEnd);
+
+	explicit operator bool() const { return bValid; }
+	FHexLineWalker& operator++();
+
+	const FIntPoint& GetTileCoord() const { return TileCoord; }
+
+	/** Part of the segment inside the current hex, 0 at the start and 1 at the end */
+	float GetEntryAlpha() const { return EntryAlpha; }
+	float GetExitAlpha() const { return ExitAlpha; }
+
+	/** Lowest world Z of the segment over the current hex, it only ever dips at one of its two ends */
+	double GetLowestHeight() const { return StartZ + FMath::Min(EntryAlpha, ExitAlpha) * DeltaZ; }
+
+	bool IsFirstTile() const { return EntryAlpha <= 0.f; }
+	bool IsLastTile() const { return ExitAlpha >= 1.f; }
+
+private:
+	void FindExit();
+
+	// Everything planar is relative to the centre of the start hex and scaled so the hexes are regular with unit spacing,
+	// which keeps long walks far from the grid origin precise and makes the hex edges the bisectors between centres
+	FVector2f Scale;
+	FVector2f Start;
+	FVector2f Delta;
+	double StartZ;
+	double DeltaZ;
+
+	FHexAxial StartAxial;
+	FHexAxial Axial;
+	FIntPoint TileCoord;
+
+	float EntryAlpha = 0.f;
+	float ExitAlpha = 0.f;
+	int32 ExitDirection = INDEX_NONE;
+	int32 StepsLeft = 0;
+	bool bValid = true;
+};
+
+/**
+ * Terrain line of sight on one grid. Trace walks the tile tops under a segment, the cache keeps tile to tile results
+ * and drops them lazily once any chunk under the line changes, using the store's chunk revisions.
+ */
+class CONTRACTRENEWED_API FHexLineOfSightCache
+{
+public:
+	static constexpr float EyeHeightStep = 5.f;
+
+	explicit FHexLineOfSightCache(int32 InMaxEntries = 16384) : MaxEntries(InMaxEntries) {}
+
+	/**
+	 * True when no tile top rises above the segment. The tiles under both ends never block, whatever stands there is
+	 * on top of them, and missing tiles count as open ground. OutBlockingTile gets the first tile in the way.
+	 */
+	static bool Trace(const FHexTileStore& TileStore, const FVector& From, const FVector& To, FIntPoint* OutBlockingTile = nullptr);
+
+	/**
+	 * Trace between eyes EyeHeight above the tops of two tiles, served from the cache while nothing under the line
+	 * changed. Symmetric, both directions share an entry. True if either tile isn't loaded.
+	 * Eye heights are rounded to EyeHeightStep and part of the entry key, so callers with different eyes share the cache.
+	 */
+	bool HasLineOfSight(const FHexTileStore& TileStore, const FIntPoint& FromTile, const FIntPoint& ToTile, float EyeHeight);
+
+	void Reset();
+	int32 GetNumEntries() const { return Entries.Num(); }
+	uint64 GetNumHits() const { return NumHits; }
+	uint64 GetNumMisses() const { return NumMisses; }
+
+private:
+	struct FEntry
+	{
+		// Store revision the result was last known to hold at
+		uint32 Revision = 0;
+
+		// Chunks the line can touch
+		FIntPoint MinChunk = FIntPoint::ZeroValue;
+		FIntPoint MaxChunk = FIntPoint::ZeroValue;
+
+		bool bVisible = false;
+	};
+
+	static bool IsEntryCurrent(const FHexTileStore& TileStore, FEntry& Entry);
+
+	// Ordered tile pair and eye height in EyeHeightSteps
+	TMap<TTuple<FIntPoint, FIntPoint, int32>, FEntry> Entries;
+	int32 MaxEntries;
+
+	uint64 NumHits = 0;
+	uint64 NumMisses = 0;
+};
@@ -6,8 +6,17 @@
 #include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "HexGridSettings.h"
 #include "FastNoiseWrapper.h"
+#include "HexNoise.h"
+#include "HexTileStore.h"
+#include "HexBiomeTable.h"
+#include "HexChunkCollisionComponent.h"
+#include "HexChunkSurface.h"
+#include "HexInfluenceMap.h"
+#include "HexMinimap.h"
+#include "HexRandom.h"
 #include "Actors/HopperBaseCharacter.h"
 #include "NavigationSystem.h"
+#include "Tasks/Task.h"
 #include "HexManager.generated.h"
 
 USTRUCT(BlueprintType)
@@ -22,6 +31,7 @@ public:
     UPROPERTY(EditAnywhere, Category = "Spawn")
     int32 SpawnAmount = 5;
 
+    // Spawn height above the top of the tile
     UPROPERTY(EditAnywhere, Category = "Spawn")
     float MinHeightOffset = 100.f;
 
@@ -38,6 +48,176 @@ public:
     bool bRandomRotate = true;
 };
 
+// One actor the spawn pass decided to place, kept so baked levels can replay the spawn without rerolling it
+USTRUCT()
+struct FHexSpawnPlanEntry
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TSubclassOf<AActor> ActorClass;
+
+    UPROPERTY()
+    FTransform Transform;
+
+    UPROPERTY()
+    FIntPoint TileCoord = FIntPoint::ZeroValue;
+};
+
+// A grid generated ahead of time, the HISM instances themselves are saved by the components
+USTRUCT()
+struct FHexBakedGrid
+{
+    GENERATED_BODY()
+
+    // Hash of the generation inputs and spawnables the bake was made from, 0 when nothing is baked
+    UPROPERTY()
+    uint64 Key = 0;
+
+    UPROPERTY()
+    TArray<FIntPoint> TileCoords;
+
+    UPROPERTY()
+    TArray<float> Heights;
+
+    // Rows of the biome table the bake was made with
+    UPROPERTY()
+    TArray<uint8> Biomes;
+
+    UPROPERTY()
+    TArray<int32> InstanceIndices;
+
+    UPROPERTY()
+    TArray<FHexSpawnPlanEntry> SpawnPlan;
+};
+
+// What one batch of runtime tile edits did to a tile, the Old values are from before the batch
+USTRUCT(BlueprintType)
+struct FHexTileChange
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "HexGrid")
+    FIntPoint TileCoord = FIntPoint::ZeroValue;
+
+    UPROPERTY(BlueprintReadOnly, Category = "HexGrid")
+    bool bRemoved = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "HexGrid")
+    float OldHeight = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "HexGrid")
+    float NewHeight = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "HexGrid")
+    uint8 OldBiome = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "HexGrid")
+    uint8 NewBiome = 0;
+};
+
+// Merged stand-in mesh for a distant chunk, shown instead of the chunk's HISM instances
+USTRUCT()
+struct FHexChunkProxy
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    UStaticMeshComponent* Component = nullptr;
+
+    // Replaced whenever the chunk's tiles change, a proxy built for an older version is stale
+    uint32 Version = 0;
+    uint32 BuiltVersion = 0;
+
+    bool bBuilding = false;
+
+    // Proxy visible and the chunk's instances handed back to the free lists
+    bool bActive = false;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnHexGridGenerated, int32, NumTiles);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnHexGridGeneratedNative, int32);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnHexTilesChanged, const TArray<FHexTileChange>&, Changes);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnHexTilesChangedNative, const TArray<FHexTileChange>&);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnHexFogChanged, int32, PlayerId, const TArray<FIntPoint>&, TileCoords);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnHexFogChangedNative, int32, const TArray<FIntPoint>&);
+
+// Plain tile data for one ChunkSize x ChunkSize chunk, filled on a worker thread and committed to the HISMs on the game thread
+struct FHexChunkBuffer
+{
+    FIntPoint ChunkCoord = FIntPoint::ZeroValue;
+    TArray<FIntPoint> TileCoords;
+    TArray<FVector> LocalPositions;
+    TArray<float> Heights;
+    TArray<uint8> Biomes;
+};
+
+enum class EHexGenerationMode : uint8
+{
+    Stream,         // Adds chunks around the viewers
+    Full,           // Adds every chunk of an empty grid and spawns actors once committed
+    Incremental,    // Diffs loaded chunks against fresh noise and only touches the tiles that changed
+};
+
+// Snapshot of everything generation reads, so workers never touch the actor or the settings object
+struct FHexGenerationInputs
+{
+    FHexSpacing Spacing;
+    float HeightStrength = 1.f;
+    int32 GridWidth = 0;
+    int32 GridHeight = 0;
+    int32 ChunkSize = 1;
+
+    // Chunks aren't clipped to GridWidth/GridHeight
+    bool bUnbounded = false;
+
+    TArray<FHexBiomeThresholds> BiomeThresholds;
+    bool bSampleMoisture = false;
+    FHexNoiseSettings MoistureSettings;
+};
+
+enum class EHexTileEditType : uint8
+{
+    Remove,
+    SetHeight,
+    AddHeight,
+    SetBiome,
+};
+
+// A queued runtime tile edit, applied with the rest of the frame's edits
+struct FHexTileEdit
+{
+    FIntPoint TileCoord = FIntPoint::ZeroValue;
+    EHexTileEditType Type = EHexTileEditType::Remove;
+    float Height = 0.f;
+    uint8 Biome = 0;
+};
+
+// Instances a commit still has to add, per mesh slot, with the tiles that will own them
+struct FHexPendingInstances
+{
+    TArray<TArray<FTransform>> Transforms;
+    TArray<TArray<int32>> Owners;
+};
+
+// Noise one generation worker samples, its own copies so workers share nothing but the inputs
+struct FHexGenerationNoise
+{
+    FHexNoiseGenerator Height;
+    TOptional<FHexNoiseGenerator> Moisture;
+
+    FHexGenerationNoise(const FHexNoiseGenerator& InHeight, const FHexNoiseGenerator* InMoisture)
+        : Height(InHeight)
+    {
+        if (InMoisture)
+        {
+            Moisture.Emplace(*InMoisture);
+        }
+    }
+};
+
 UCLASS()
 class CONTRACTRENEWED_API AHexManager : public AActor
 {
@@ -46,15 +226,227 @@ class CONTRACTRENEWED_API AHexManager : public AActor
 public:
     AHexManager();
 
+    virtual void ApplyWorldOffset(const FVector& InOffset, bool bWorldShift) override;
+
+    /**
+     * Generates the whole grid synchronously into the HISMs and records the tile table and spawn plan in BakedGrid,
+     * so BeginPlay can restore it without sampling noise or waiting on the navmesh. Used by the HexGridBake
+     * commandlet, which saves the baked levels. Streaming grids aren't baked.
+     */
+    bool BakeGrid();
+
+    /** Writes the highlight custom data float of the tile at TileCoord, the tile materials decide what it looks like */
+    UFUNCTION(BlueprintCallable, Category = "HexGrid")
+    void SetTileHighlight(FIntPoint TileCoord, float Highlight);
+
+    /**
+     * Hides the tile's HISM instance and puts a pooled AHexTile in its place, for tiles that need behaviour of their own
+     * while they're interacted with, animate or break. The actor follows edits to the tile and goes back to the pool
+     * on DemoteTile, or when the tile is removed, unloaded or drawn by a chunk proxy. Null if the tile has no instance.
+     */
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Promotion")
+    AHexTile* PromoteTile(FIntPoint TileCoord);
+
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Promotion")
+    void DemoteTile(FIntPoint TileCoord);
+
+    UFUNCTION(BlueprintPure, Category = "HexGrid|Promotion")
+    AHexTile* FindPromotedTile(FIntPoint TileCoord) const;
+
+    /*
+     * Runtime tile edits. Edits are queued and applied together at the start of the next frame, so a crater
+     * touching dozens of tiles costs one instance update. Instances of removed or re-meshed tiles are hidden and
+     * recycled rather than removed, every other tile keeps its instance index.
+     * Height edits ending beyond GetMaxTileHeight are rejected with a warning, the tile keeps its height.
+     */
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Edit")
+    void RemoveTile(FIntPoint TileCoord);
+
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Edit")
+    void SetTileHeight(FIntPoint TileCoord, float Height);
+
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Edit")
+    void RaiseTile(FIntPoint TileCoord, float Amount);
+
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Edit")
+    void LowerTile(FIntPoint TileCoord, float Amount);
+
+    /** Largest absolute tile height the grid can store, see TileEditHeightRange */
+    UFUNCTION(BlueprintPure, Category = "HexGrid|Edit")
+    float GetMaxTileHeight() const;
+
+    /** Biome is a row of the biome table, see FindBiome */
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Edit")
+    void SetTileBiome(FIntPoint TileCoord, int32 Biome);
+
+    /** Row of the active biome table with that name, INDEX_NONE if there is none */
+    UFUNCTION(BlueprintPure, Category = "HexGrid|Edit")
+    int32 FindBiome(FName BiomeName) const;
+
+    /** Applies queued edits now instead of next frame, OnHexTilesChanged fires before this returns */
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Edit")
+    void ApplyTileEdits();
+
+    /** Switches between per-instance and merged chunk collision, loaded chunks are rebuilt in the new mode right away */
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Collision")
+    void SetCollisionMode(EHexCollisionMode InCollisionMode);
+
+    /** Logs physics memory and floor sweep cost in every collision mode, one mode every half second, then restores the current one */
+    void BenchmarkCollision();
+
+    /** Hash of the spawn plan the loaded tiles and Seed give, equal for equal inputs on every run, client and thread */
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Testing")
+    int64 GetSpawnPlanHash() const;
+
+    /**
+     * Places InSpawnables on the given tiles, a pure function of GridSeed, the spawnables and the set of tiles.
+     * Each spawnable reserves candidate tiles and rolls its offsets from its own stream, independent of the others,
+     * and the draws run in parallel. Only settling which spawnable gets a contested tile follows the list order:
+     * a spawnable skips tiles taken before it and stacks on tiles taken by anyone before it
+     */
+    static void BuildSpawnPlan(int32 GridSeed, const TArray<FSpawnableData>& InSpawnables, const TArray<FVector>& TilePositions,
+                               const TArray<FIntPoint>& TileCoords, TArray<FHexSpawnPlanEntry>& OutSpawnPlan);
+    static uint64 HashSpawnPlan(TConstArrayView<FHexSpawnPlanEntry> SpawnPlan);
+
+    /**
+     * Moves the actor onto TileCoord (rounded to even coordinates) and re-places every instance relative to it.
+     * Tiles keep their world positions and nothing is regenerated, only the local space of the grid moves.
+     */
+    UFUNCTION(BlueprintCallable, Category = "HexGrid|Rebasing")
+    void RebaseGrid(FIntPoint TileCoord);
+
+    /** Top-down picture of the grid kept up to date while bUseMinimap is on, null until the first update */
+    UFUNCTION(BlueprintPure, Category = "HexGrid|Minimap")
+    UTexture2D* GetMinimapTexture() const { return MinimapTexture; }
+
+    /* Broadcast on the game thread once a GenerateHexGrid request has been committed to the HISMs */
+    UPROPERTY(BlueprintAssignable, Category = "Delegates")
+    FOnHexGridGenerated OnHexGridGenerated;
+    FOnHexGridGeneratedNative OnHexGridGeneratedNative;
+
+    /* Broadcast once per applied batch of tile edits, with one entry per tile that actually changed */
+    UPROPERTY(BlueprintAssignable, Category = "Delegates")
+    FOnHexTilesChanged OnHexTilesChanged;
+    FOnHexTilesChangedNative OnHexTilesChangedNative;
+
+    /* Broadcast per player after a fog of war update, with the tiles that came into or went out of their sight */
+    UPROPERTY(BlueprintAssignable, Category = "Delegates")
+    FOnHexFogChanged OnHexFogChanged;
+    FOnHexFogChangedNative OnHexFogChangedNative;
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     void DestroyTiles();
 
-    UFUNCTION(CallInEditor, Category = "HexGrid|Testing")
+    // Tile data lives in the grid subsystem, keyed by this manager
+    FHexTileStore* GetTileStore() const;
+    void ResetTileStore();
+
+    /** Empties TileStore and sets it up for this grid's chunk size, height range, biomes, placement and tile tops */
+    void ConfigureTileStore(FHexTileStore& TileStore) const;
+
+    /**
+     * Generates the grid on a worker thread and commits it on the game thread,
+     * OnHexGridGenerated fires once the instances are in place.
+     */
+    UFUNCTION(CallInEditor, BlueprintCallable, Category = "HexGrid|Testing")
     void GenerateHexGrid();
 
+    // Chunk streaming
+    void UpdateStreamedChunks();
+    void StreamChunksAroundViewers(int32 MaxChunksToLoad, bool bFullGrid);
+    void ReleaseChunk(const FIntPoint& ChunkCoord);
+    void ReleaseInstance(uint8 MeshSlot, int32 InstanceIndex);
+
+    // Gives a tile an instance of its biome's HISM, recycled when possible and otherwise queued in Pending
+    void PlaceTileInstance(FHexPendingInstances& Pending, int32 TileIndex, const FVector& LocalPos, uint8 Biome);
+    void AddPendingInstances(FHexPendingInstances& Pending);
+
+    // Tile edits
+    void QueueTileEdit(const FHexTileEdit& Edit);
+    void BroadcastTilesChanged(const TArray<FHexTileChange>& Changes);
+    void GetViewerLocations(TArray<FVector>& OutLocations) const;
+    FIntPoint GetChunkCoordAt(const FVector& WorldLocation) const;
+
+    // Rebasing
+    void UpdateGridAnchor();
+
+    // Biomes
+    bool SetupBiomes();
+    UHierarchicalInstancedStaticMeshComponent* GetMeshComp(int32 MeshSlot);
+    void WriteInstanceCustomData(uint8 MeshSlot, int32 InstanceIndex, uint8 Biome, float Highlight, float Fog);
+    float GetInstanceHighlight(uint8 MeshSlot, int32 InstanceIndex) const;
+
+    // Fog of war, the tile materials draw the locally controlled player's view from the fog custom data float
+    void UpdateFogOfWar();
+    float GetTileFog(const FIntPoint& TileCoord) const;
+    void WriteFogCustomData(TConstArrayView<FIntPoint> TileCoords);
+
+    // Tile promotion, keeps promoted actors on their tiles and instances hidden after instance updates
+    void SyncPromotedTiles();
+    void ReleaseTileActor(AHexTile* TileActor);
+
+    // Influence maps, collects the finished step, queues this interval's sources and launches the next one
+    void UpdateInfluenceMaps();
+
+    // Minimap, uploads the finished raster, recolours tiles of changed chunks and launches the next raster
+    void UpdateMinimap();
+    FColor GetMinimapColour(const FHexTileStore& TileStore, int32 TileIndex) const;
+
+    // Merged collision, dirty chunks are rebuilt by FinishInstanceUpdates
+    void GetTileExtents(TArray<FHexTileExtent>& OutExtents) const;
+    void ApplyInstanceCollision();
+    bool NeedsChunkCollision(const FIntPoint& ChunkCoord) const;
+    void MarkCollisionDirty(const FIntPoint& ChunkCoord);
+    void UpdateChunkCollision();
+    void ReleaseChunkCollision(const FIntPoint& ChunkCoord);
+    void RunCollisionBenchmarkStep(int32 Step, EHexCollisionMode RestoreMode);
+    void LogCollisionCost();
+
+    // Proxy meshes
+    void UpdateChunkProxies();
+    void GetCameraLocations(TArray<FVector>& OutLocations) const;
+    void LaunchProxyBuild(const FIntPoint& ChunkCoord);
+    void OnProxyBuilt(const FIntPoint& ChunkCoord, uint32 Version, FMeshDescription&& MeshDescription);
+    void ActivateChunkProxy(const FIntPoint& ChunkCoord);
+    void DeactivateChunkProxy(const FIntPoint& ChunkCoord, FHexPendingInstances& Pending);
+
+    // Called before a chunk's tiles change, brings its instances back and marks the proxy stale
+    void InvalidateChunkProxy(const FIntPoint& ChunkCoord);
+    void ReleaseChunkProxy(const FIntPoint& ChunkCoord);
+    bool IsChunkProxied(const FIntPoint& ChunkCoord) const;
+
+    // Async generation
+    FHexNoiseSettings GetNoiseSettings() const;
+    FHexNoiseSettings GetMoistureNoiseSettings() const;
+    FHexGenerationInputs MakeGenerationInputs() const;
+    void GetChunksInBounds(TArray<FIntPoint>& OutChunkCoords) const;
+    void LaunchGeneration(TArray<FIntPoint>&& ChunkCoords, EHexGenerationMode Mode);
+    void OnGenerationFinished(TArray<FHexChunkBuffer>&& ChunkBuffers, EHexGenerationMode Mode);
+
+    /** Adds chunks that aren't loaded yet, with OutHeightDeltas set loaded chunks are diffed and changed tiles reported */
+    void CommitChunkBuffers(const TArray<FHexChunkBuffer>& ChunkBuffers, TMap<int32, float>* OutHeightDeltas = nullptr);
+    void CommitIncrementalRegeneration(const TArray<FHexChunkBuffer>& ChunkBuffers);
+    bool CanRegenerateIncrementally() const;
+    void FinishInstanceUpdates();
+    static void BuildChunkTiles(const FHexGenerationInputs& Inputs, const FHexGenerationNoise& Noise, FHexChunkBuffer& OutChunk);
+
+    static void GenerateChunkBuffers(const FHexGenerationInputs& Inputs, const FHexNoiseGenerator& HeightNoise,
+                                     const FHexNoiseGenerator* MoistureNoise, const FString& CachePath, uint64 CacheKey,
+                                     bool bCanWriteCache, const TArray<FIntPoint>& ChunkCoords,
+                                     TArray<FHexChunkBuffer>& OutChunkBuffers);
+    void BroadcastGridGenerated(int32 NumTiles);
+
+    // Baking
+    uint64 MakeBakeKey() const;
+    bool RestoreBakedGrid();
+
     void SpawnEnemiesAfterNavMeshReady();
+    void GetSpawnTiles(TArray<FVector>& OutTilePositions, TArray<FIntPoint>& OutTileCoords) const;
+    static void GetSpawnTiles(const FHexTileStore& TileStore, TArray<FVector>& OutTilePositions, TArray<FIntPoint>& OutTileCoords);
+    void SpawnFromPlan(const TArray<FHexSpawnPlanEntry>& SpawnPlan);
 
     // Unified spawn system
     UFUNCTION(BlueprintCallable, Category = "HexGrid")
@@ -63,6 +455,31 @@ protected:
     UFUNCTION(CallInEditor, Category = "HexGrid|Testing")
     void SpawnAllActorsInEditor();
 
+#if WITH_EDITOR
+    // Spawn preview, the spawn plan drawn as one instanced mesh per spawnable class instead of spawned actors
+    bool ShouldPreviewSpawns() const;
+    void UpdateSpawnPreview();
+    UInstancedStaticMeshComponent* GetSpawnPreviewComp(TSubclassOf<AActor> ActorClass);
+
+    UFUNCTION(CallInEditor, Category = "HexGrid|Testing")
+    void ClearSpawnPreview();
+#endif
+
+#if WITH_EDITORONLY_DATA
+    // GenerateHexGrid in the editor draws the spawn plan with instanced proxies instead of spawning the actors,
+    // so seeds can be scrubbed without the level filling up with enemies and pickups
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Testing")
+    bool bPreviewSpawnsInEditor = true;
+
+    // Drawn for spawnable classes without a static mesh component of their own, an engine cube when unset
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Testing", meta = (EditCondition = "bPreviewSpawnsInEditor"))
+    UStaticMesh* SpawnPreviewMesh = nullptr;
+
+    // Reused by every preview, only their instances are replaced
+    UPROPERTY(Transient)
+    TMap<TSubclassOf<AActor>, UInstancedStaticMeshComponent*> SpawnPreviewComps;
+#endif
+
     // --- Tile & Grid Data ---
     UPROPERTY(EditAnywhere, Category = "HexGrid|Layout")
     int32 GridWidth = 3;
@@ -73,10 +490,31 @@ protected:
     UPROPERTY(EditAnywhere, Category = "HexGrid|Setup")
     float HeightStrength = 1.f;
 
+    // Runtime edits can move a tile up to HeightStrength times this far from the grid plane, so repairs and bridges fit
+    // above the noise range. Tile heights are stored as int16 across that range, a larger range costs height precision
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Setup", meta = (ClampMin = "1.0"))
+    float TileEditHeightRange = 8.f;
+
+    // Regenerating a populated grid only rewrites tiles whose height or biome changed, actors on the rest stay put.
+    // Changing HeightStrength, TileEditHeightRange, ChunkSize, the tile spacing or the biome meshes and looks still rebuilds from scratch
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Setup")
+    bool bIncrementalRegeneration = true;
+
+    // Full generations are written to Saved/HexGridCache keyed by every generation input, later loads map the file instead of sampling noise
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Setup")
+    bool bUseGridCache = true;
+
+    UPROPERTY()
+    FHexBakedGrid BakedGrid;
+
+    // Maps noise height and moisture to tile types and meshes, without one tiles are grass at or above 0 and water below
     UPROPERTY(EditAnywhere, Category = "HexGrid")
+    UHexBiomeTable* BiomeTable = nullptr;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid", meta = (EditCondition = "BiomeTable == nullptr"))
     UStaticMesh* GrassMesh;
 
-    UPROPERTY(EditAnywhere, Category = "HexGrid")
+    UPROPERTY(EditAnywhere, Category = "HexGrid", meta = (EditCondition = "BiomeTable == nullptr"))
     UStaticMesh* WaterMesh;
 
     UPROPERTY(VisibleDefaultsOnly, Category = "Hex", meta = (AllowPrivateAccess = "true"))
@@ -85,6 +523,135 @@ protected:
     UPROPERTY(VisibleDefaultsOnly, Category = "Hex", meta = (AllowPrivateAccess = "true"))
     UHierarchicalInstancedStaticMeshComponent* WaterMeshComp;
 
+    // One HISM per distinct biome mesh, indexed by mesh slot. The grass and water components take the first two slots
+    UPROPERTY(VisibleInstanceOnly, Category = "Hex")
+    TArray<UHierarchicalInstancedStaticMeshComponent*> MeshComps;
+
+    // --- Collision ---
+    // Per-instance bodies grow the physics scene with every tile, the chunk modes give each chunk one body instead
+    // and turn collision off on the HISMs
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Collision")
+    EHexCollisionMode CollisionMode = EHexCollisionMode::PerInstance;
+
+    // --- Proxy meshes ---
+    // Loaded chunks farther than ProxyDistance from every player camera are drawn as one merged mesh of their tile tops,
+    // built on a worker thread, and give their HISM instances back for nearer chunks to reuse
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Proxy")
+    bool bUseProxyMeshes = false;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Proxy", meta = (EditCondition = "bUseProxyMeshes", ClampMin = "0.0", Units = "cm"))
+    float ProxyDistance = 8000.f;
+
+    // Proxied chunks only switch back to instances this much closer than ProxyDistance, so cameras on the boundary don't flicker
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Proxy", meta = (EditCondition = "bUseProxyMeshes", ClampMin = "0.0", Units = "cm"))
+    float ProxyHysteresis = 1000.f;
+
+    // Should read the biome colour from the vertex colour, without one the proxies use the first biome mesh's material
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Proxy", meta = (EditCondition = "bUseProxyMeshes"))
+    UMaterialInterface* ProxyMaterial = nullptr;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Proxy", meta = (EditCondition = "bUseProxyMeshes", ClampMin = "1"))
+    int32 MaxProxyBuildsPerUpdate = 2;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Proxy", meta = (EditCondition = "bUseProxyMeshes", ClampMin = "0.01"))
+    float ProxyUpdateInterval = 0.5f;
+
+    // --- Streaming ---
+    // When enabled only the chunks around each player are kept generated, GridWidth/GridHeight become the world bounds
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Streaming")
+    bool bUseChunkStreaming = false;
+
+    // Tiles per chunk side
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Streaming", meta = (ClampMin = "1"))
+    int32 ChunkSize = 16;
+
+    // Chunks kept loaded around each player, chunks beyond StreamingRadius + 1 are released
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Streaming", meta = (EditCondition = "bUseChunkStreaming", ClampMin = "0"))
+    int32 StreamingRadius = 2;
+
+    // Caps how many chunks are generated per update so crossing a chunk border doesn't hitch
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Streaming", meta = (EditCondition = "bUseChunkStreaming", ClampMin = "1"))
+    int32 MaxChunksLoadedPerUpdate = 2;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Streaming", meta = (EditCondition = "bUseChunkStreaming", ClampMin = "0.01"))
+    float StreamingUpdateInterval = 0.25f;
+
+    // Streams chunks wherever the players go, GridWidth/GridHeight no longer bound the world
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Streaming", meta = (EditCondition = "bUseChunkStreaming"))
+    bool bUnboundedGrid = false;
+
+    // --- Rebasing ---
+    // Moves the grid under the first player once they get RebaseDistance away from it, so nearby instances keep full precision.
+    // Only streamed unbounded grids rebase, bounded grids never get far enough to gain anything from it
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Rebasing", meta = (EditCondition = "bUseChunkStreaming && bUnboundedGrid"))
+    bool bRebaseGrid = false;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Rebasing", meta = (EditCondition = "bRebaseGrid", ClampMin = "1000.0", Units = "cm"))
+    float RebaseDistance = 100000.f;
+
+    // Also shifts the world origin onto the player on each rebase, moving every actor with it. Needs world origin rebasing enabled in the world settings
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Rebasing", meta = (EditCondition = "bRebaseGrid"))
+    bool bRebaseWorldOrigin = false;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Rebasing", meta = (EditCondition = "bRebaseGrid", ClampMin = "0.01"))
+    float RebaseCheckInterval = 1.f;
+
+    // --- Fog of war ---
+    // Tracks what each player has explored and sees from their pawn, hiding tiles behind higher tiles
+    UPROPERTY(EditAnywhere, Category = "HexGrid|FogOfWar")
+    bool bUseFogOfWar = false;
+
+    // Tiles a pawn sees in every direction
+    UPROPERTY(EditAnywhere, Category = "HexGrid|FogOfWar", meta = (EditCondition = "bUseFogOfWar", ClampMin = "0"))
+    int32 FogSightRadius = 8;
+
+    // Eye height above the top of the tile the pawn stands on
+    UPROPERTY(EditAnywhere, Category = "HexGrid|FogOfWar", meta = (EditCondition = "bUseFogOfWar", ClampMin = "0.0", Units = "cm"))
+    float FogEyeHeight = 150.f;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|FogOfWar", meta = (EditCondition = "bUseFogOfWar", ClampMin = "0.01"))
+    float FogUpdateInterval = 0.1f;
+
+    // --- Influence maps ---
+    // Keeps shared per-tile threat, enemy and pickup layers AI can sample instead of running their own queries
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Influence")
+    bool bUseInfluenceMaps = false;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Influence", meta = (EditCondition = "bUseInfluenceMaps", ArraySizeEnum = "EHexInfluenceLayer"))
+    FHexInfluenceLayerSettings InfluenceLayers[static_cast<int32>(EHexInfluenceLayer::Num)];
+
+    // Seconds between diffusion steps, a step still running when the next is due delays it
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Influence", meta = (EditCondition = "bUseInfluenceMaps", ClampMin = "0.01"))
+    float InfluenceStepInterval = 0.1f;
+
+    // Streaming grids keep influence in a window of this many tiles around the first player, others cover the whole grid
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Influence", meta = (EditCondition = "bUseInfluenceMaps"))
+    FIntPoint InfluenceWindowSize = FIntPoint(128, 128);
+
+    // --- Tile promotion ---
+    // Spawned for promoted tiles, see PromoteTile
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Promotion")
+    TSubclassOf<AHexTile> PromotedTileClass;
+
+    // Demoted actors kept hidden for the next promotions, any beyond this are destroyed
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Promotion", meta = (ClampMin = "0"))
+    int32 MaxPooledTileActors = 16;
+
+    // --- Minimap ---
+    // Rasterizes a texture of the tiles off the game thread, see GetMinimapTexture. Tiles are shaded by height and fog
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Minimap")
+    bool bUseMinimap = false;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Minimap", meta = (EditCondition = "bUseMinimap", ClampMin = "1.0"))
+    float MinimapPixelsPerTile = 4.f;
+
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Minimap", meta = (EditCondition = "bUseMinimap", ClampMin = "0.01"))
+    float MinimapUpdateInterval = 0.25f;
+
+    // Streaming grids draw a window of this many tiles around the first player, others the whole grid
+    UPROPERTY(EditAnywhere, Category = "HexGrid|Minimap", meta = (EditCondition = "bUseMinimap"))
+    FIntPoint MinimapWindowSize = FIntPoint(256, 256);
+
     // --- Spawning Data ---
     UPROPERTY(EditAnywhere, Category = "Spawning")
     TArray<FSpawnableData> Spawnables; // replaces PickupSpawnData, PropActors, EnemyTypes arrays
@@ -128,5 +695,83 @@ protected:
 
 private:
     UHexGridSettings* Settings;
-    TArray<FVector> TilePositions;
+
+    // Biome rows in use and what the tile store needs to know about each, filled by SetupBiomes
+    TArray<FHexBiome> ActiveBiomes;
+    TArray<FHexTileBiome> ActiveTileBiomes;
+
+    // Hash of the meshes, tile types and looks of ActiveBiomes, loaded tiles only diff against the layout they were built with
+    uint32 BiomeLayoutHash = 0;
+    uint32 CommittedBiomeLayoutHash = 0;
+
+    // Instances of released chunks are hidden and recycled instead of removed, so indices held by loaded chunks stay valid.
+    // One list per mesh slot
+    TArray<TArray<int32>> FreeInstances;
+
+    // Merged collision of loaded chunks, bodies of released chunks are kept for reuse
+    UPROPERTY(Transient)
+    TMap<FIntPoint, UHexChunkCollisionComponent*> ChunkCollision;
+
+    UPROPERTY(Transient)
+    TArray<UHexChunkCollisionComponent*> FreeChunkCollision;
+
+    TSet<FIntPoint> DirtyCollisionChunks;
+
+    UPROPERTY(Transient)
+    TMap<FIntPoint, FHexChunkProxy> ChunkProxies;
+
+    UPROPERTY(Transient)
+    TArray<UStaticMeshComponent*> FreeProxyComponents;
+
+    // Source of FHexChunkProxy::Version, never reused so builds for a released chunk can't match its replacement
+    uint32 LastProxyVersion = 0;
+
+    FTimerHandle ProxyTimer;
+
+    FTimerHandle StreamingTimer;
+
+    // Tile the actor sits on, instances are placed relative to it. Only RebaseGrid moves it
+    FIntPoint AnchorTile = FIntPoint::ZeroValue;
+
+    FTimerHandle RebaseTimer;
+
+    // Fog of war viewer of each player controller with a pawn
+    TMap<TObjectKey<APlayerController>, int32> FogViewers;
+
+    // Player whose view the fog custom data shows, INDEX_NONE until a local player has a player state
+    int32 FogRenderPlayerId = INDEX_NONE;
+
+    FTimerHandle FogTimer;
+
+    FTimerHandle InfluenceTimer;
+
+    // Actors standing in for promoted tiles, their HISM instances stay allocated but hidden
+    UPROPERTY(Transient)
+    TMap<FIntPoint, AHexTile*> PromotedTiles;
+
+    UPROPERTY(Transient)
+    TArray<AHexTile*> FreeTileActors;
+
+    UPROPERTY(Transient)
+    UTexture2D* MinimapTexture = nullptr;
+
+    FHexMinimap Minimap;
+
+    // Chunk revision each loaded chunk was last drawn at, chunks missing from the store since are cleared
+    TMap<FIntPoint, uint32> MinimapChunkRevisions;
+
+    FTimerHandle MinimapTimer;
+
+    // Pending spawn after a full generation, cleared by the next one so repeated requests don't spawn twice
+    FTimerHandle SpawnTimer;
+
+    TArray<FHexTileEdit> PendingTileEdits;
+    bool bTileEditsScheduled = false;
+
+    UE::Tasks::FTask GenerationTask;
+    bool bGenerationInFlight = false;
+    bool bFullGenerationPending = false;
+
+    // Set once BeginPlay restored BakedGrid, runtime GenerateHexGrid calls only announce it until the settings change
+    bool bBakedGridRestored = false;
 };
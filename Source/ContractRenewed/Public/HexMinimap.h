@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexLayout.h"
+#include "Tasks/Task.h"
+
+class UTexture2D;
+
+// Which tiles a minimap covers and how large it draws them
+struct FHexMinimapLayout
+{
+	// Even, so locations relative to it don't depend on the odd row shift
+	FIntPoint MinTile = FIntPoint::ZeroValue;
+	FIntPoint NumTiles = FIntPoint::ZeroValue;
+	FHexSpacing Spacing;
+	float PixelsPerTile = 4.f;
+
+	bool operator==(const FHexMinimapLayout& Other) const
+	{
+		return MinTile == Other.MinTile && NumTiles == Other.NumTiles && Spacing.Column == Other.Spacing.Column
+			&& Spacing.Row == Other.Spacing.Row && PixelsPerTile == Other.PixelsPerTile;
+	}
+
+	float GetWorldPerPixel() const { return Spacing.Column / PixelsPerTile; }
+	FIntPoint GetTextureSize() const;
+
+	/** Pixels the hex of TileCoord can touch, clipped to the texture */
+	FIntRect GetTilePixelRect(const FIntPoint& TileCoord) const;
+};
+
+/**
+ * Top-down picture of a window of the grid, one flat colour per tile. Pixels are worked out on a worker thread by hex
+ * rounding their centres, only for the 32 x 32 pixel blocks whose tiles changed, and only those blocks are uploaded.
+ * Tile colours are copied on write while a raster runs, so setting them never waits on the worker.
+ * Game thread only, Rasterize itself is pure and safe anywhere.
+ */
+class CONTRACTRENEWED_API FHexMinimap
+{
+public:
+	static constexpr int32 BlockSize = 32;
+
+	~FHexMinimap();
+
+	/** Clears every tile to transparent and marks the whole picture dirty. Waits for a running raster */
+	void SetLayout(const FHexMinimapLayout& InLayout);
+	const FHexMinimapLayout& GetLayout() const { return Layout; }
+
+	/** Marks the blocks under the tile dirty if its colour changed, tiles outside the window are ignored */
+	void SetTileColour(const FIntPoint& TileCoord, const FColor& Colour);
+	bool IsInWindow(const FIntPoint& TileCoord) const;
+
+	/** Starts rasterizing the dirty blocks on a worker, false if nothing is dirty or a raster still runs */
+	bool LaunchRaster();
+
+	/** Uploads the blocks of a completed raster to Texture when there is one, true if a raster completed */
+	bool FinishRaster(UTexture2D* Texture);
+
+	/** Rasterizes every dirty block on the calling thread */
+	void RasterizeNow();
+
+	bool IsRasterRunning() const { return RasterTask.IsValid(); }
+	int32 GetNumDirtyBlocks() const { return DirtyBlocks.CountSetBits(); }
+
+	/** The picture as of the last finished raster, GetLayout().GetTextureSize() pixels row by row */
+	TConstArrayView<FColor> GetPixels() const { return Pixels; }
+
+	/** Colours the pixels of PixelRect from TileColours, which holds NumTiles.X * NumTiles.Y colours row by row */
+	static void Rasterize(const FHexMinimapLayout& Layout, TConstArrayView<FColor> TileColours, const FIntRect& PixelRect, TArrayView<FColor> OutPixels);
+
+private:
+	FIntRect GetBlockRect(int32 Block) const;
+	void TakeDirtyBlocks();
+
+	FHexMinimapLayout Layout;
+	FIntPoint TextureSize = FIntPoint::ZeroValue;
+	FIntPoint NumBlocks = FIntPoint::ZeroValue;
+
+	// Shared with a running raster, replaced by a copy before the game thread writes to it then
+	TSharedPtr<TArray<FColor>, ESPMode::ThreadSafe> TileColours;
+
+	TArray<FColor> Pixels;
+	TBitArray<> DirtyBlocks;
+
+	// Blocks the running or last raster covers
+	TArray<int32> RasterBlocks;
+	UE::Tasks::FTask RasterTask;
+};
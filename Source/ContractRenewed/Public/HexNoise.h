@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FastNoiseWrapper.h"
+#include "FastNoise/FastNoise.h"
+
+// Every input UFastNoiseWrapper::SetupFastNoise takes, so noise can be described without a configured wrapper
+struct FHexNoiseSettings
+{
+	EFastNoise_NoiseType NoiseType = EFastNoise_NoiseType::Simplex;
+	int32 Seed = 1337;
+	float Frequency = 0.01f;
+	EFastNoise_Interp Interp = EFastNoise_Interp::Quintic;
+	EFastNoise_FractalType FractalType = EFastNoise_FractalType::FBM;
+	int32 Octaves = 3;
+	float Lacunarity = 2.0f;
+	float Gain = 0.5f;
+	float CellularJitter = 0.45f;
+	EFastNoise_CellularDistanceFunction CellularDistanceFunction = EFastNoise_CellularDistanceFunction::Euclidean;
+	EFastNoise_CellularReturnType CellularReturnType = EFastNoise_CellularReturnType::CellValue;
+
+	bool operator==(const FHexNoiseSettings& Other) const;
+	friend uint32 GetTypeHash(const FHexNoiseSettings& NoiseSettings);
+};
+
+/**
+ * Simplex and FBM simplex noise evaluated four samples at a time.
+ * Uses the same seed permutation and simplex construction as FastNoise, so it can stand in
+ * for UFastNoiseWrapper::GetNoise2D on the paths it supports. Immutable once built.
+ */
+class CONTRACTRENEWED_API FHexSimplexNoise
+{
+public:
+	explicit FHexSimplexNoise(const FHexNoiseSettings& InSettings);
+
+	/** True for Simplex and for SimplexFractal with FBM, everything else needs the wrapper */
+	static bool SupportsSettings(const FHexNoiseSettings& InSettings);
+
+	float GetNoise2D(float X, float Y) const;
+
+	/** Writes the noise at (X[i], Y[i]) into OutValues[i], OutValues must hold at least X.Num() entries */
+	void GetNoise2DBatch(TConstArrayView<float> X, TConstArrayView<float> Y, TArrayView<float> OutValues) const;
+
+private:
+	float SingleSimplex(uint8 Offset, float X, float Y) const;
+	VectorRegister4Float SingleSimplex4(uint8 Offset, const VectorRegister4Float& X, const VectorRegister4Float& Y) const;
+
+	FORCEINLINE uint8 Index2D12(uint8 Offset, int32 X, int32 Y) const
+	{
+		return Perm12[(X & 0xff) + Perm[(Y & 0xff) + Offset]];
+	}
+
+	uint8 Perm[512];
+	uint8 Perm12[512];
+
+	float Frequency;
+	float Lacunarity;
+	float Gain;
+	float FractalBounding;
+	int32 Octaves;
+	bool bFractal;
+};
+
+/**
+ * Noise for one set of settings, configured on construction and immutable after that, so any number of
+ * threads can sample the same generator. Simplex and FBM simplex run through FHexSimplexNoise, every other
+ * noise type through a FastNoise instance owned by the generator rather than a shared UFastNoiseWrapper.
+ * Copies are independent and only a few KB, workers take their own to keep the tables in their own cache.
+ */
+class CONTRACTRENEWED_API FHexNoiseGenerator
+{
+public:
+	explicit FHexNoiseGenerator(const FHexNoiseSettings& InSettings);
+
+	const FHexNoiseSettings& GetSettings() const { return Settings; }
+
+	/** True when batches are sampled four lanes at a time */
+	bool IsVectorized() const { return SimplexNoise.IsSet(); }
+
+	float GetNoise2D(float X, float Y) const;
+
+	/** Writes the noise at (X[i], Y[i]) into OutValues[i], OutValues must hold at least X.Num() entries */
+	void GetNoise2DBatch(TConstArrayView<float> X, TConstArrayView<float> Y, TArrayView<float> OutValues) const;
+
+private:
+	FHexNoiseSettings Settings;
+	TOptional<FHexSimplexNoise> SimplexNoise;
+	TOptional<FastNoise> ScalarNoise;
+};
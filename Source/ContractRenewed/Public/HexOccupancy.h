@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexIterators.h"
+
+/**
+ * Which actors stand on which tiles of one grid. Actors are only moved between lists when they cross into another hex,
+ * so "who is near" becomes a walk over the handful of tiles in range instead of a physics overlap.
+ * Lists hold weak pointers and skip actors destroyed without being removed. Game thread only.
+ */
+class CONTRACTRENEWED_API FHexOccupancy
+{
+public:
+	void Add(AActor* Actor, const FIntPoint& TileCoord);
+	void Remove(const AActor* Actor, const FIntPoint& TileCoord);
+	void Move(AActor* Actor, const FIntPoint& FromTile, const FIntPoint& ToTile);
+	void Reset();
+
+	int32 GetNumOccupants(const FIntPoint& TileCoord) const;
+
+	/** Calls Function(AActor*, TileCoord) for every live actor on a tile within Radius steps of CentreTile */
+	template <typename FunctionType>
+	void ForEachOccupantInRange(const FIntPoint& CentreTile, int32 Radius, FunctionType&& Function) const;
+
+	int32 GetNumOccupiedTiles() const { return Tiles.Num(); }
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	// Most tiles hold one actor or none, empty lists are dropped from the map
+	using FOccupants = TArray<TWeakObjectPtr<AActor>, TInlineAllocator<2>>;
+
+	TMap<FIntPoint, FOccupants> Tiles;
+};
+
+template <typename FunctionType>
+void FHexOccupancy::ForEachOccupantInRange(const FIntPoint& CentreTile, int32 Radius, FunctionType&& Function) const
+{
+	if (Tiles.IsEmpty()) return;
+
+	for (FHexRangeIterator It(FHexGridLayout::OffsetToAxial(FHexOffset(CentreTile)), Radius); It; ++It)
+	{
+		const FIntPoint TileCoord = FHexGridLayout::AxialToOffset(*It).ToIntPoint();
+		const FOccupants* Occupants = Tiles.Find(TileCoord);
+		if (!Occupants) continue;
+
+		for (const TWeakObjectPtr<AActor>& Occupant : *Occupants)
+		{
+			if (AActor* Actor = Occupant.Get())
+			{
+				Function(Actor, TileCoord);
+			}
+		}
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+/*
+ * Random streams derived from a grid's seed. Every system draws from streams of its own, keyed by what it works on,
+ * so results are the same for the same seed whatever order or thread the work runs on. Nothing here touches the
+ * global FMath random state.
+ */
+namespace HexRandom
+{
+	enum class EStream : uint32
+	{
+		SpawnPlan = 1,	// Keyed by spawnable index
+	};
+
+	inline FRandomStream MakeStream(int32 GridSeed, EStream Stream, uint32 Key)
+	{
+		// Finalized so neighbouring seeds and keys start unrelated sequences
+		const uint32 Hash = HashCombineFast(HashCombineFast(::GetTypeHash(GridSeed), static_cast<uint32>(Stream)), Key);
+		return FRandomStream(static_cast<int32>(MurmurFinalize32(Hash)));
+	}
+}
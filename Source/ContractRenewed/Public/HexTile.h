@@ -4,15 +4,24 @@
 #include "GameFramework/Actor.h"
 #include "HexTile.generated.h"
 
+class UStaticMesh;
+
 UENUM()
 enum class EHexTileType : uint8
 {
 	INVALID,
 	GRASS,
 	WATER,
+	SAND,
+	ROCK,
+	SNOW,
 	MAX UMETA(Hidden)
 };
 
+/**
+ * Stand-in for a grid tile that needs behaviour of its own. Tiles are drawn by the grid's HISMs, AHexManager::PromoteTile
+ * hides the tile's instance and hands out a pooled AHexTile in its place until the tile is demoted again.
+ */
 UCLASS()
 class CONTRACTRENEWED_API AHexTile : public AActor
 {
@@ -21,10 +30,28 @@ class CONTRACTRENEWED_API AHexTile : public AActor
 public:
 	AHexTile();
 
+	// Offset coordinate of the tile this actor stands in for
 	UPROPERTY(VisibleInstanceOnly, Category = "Tile")
 	FIntPoint TileIndex = {};
 
+	/** Takes over the look of a tile, called by the grid when the actor leaves the pool or its tile changes */
+	void SetupTile(const FIntPoint& InTileCoord, EHexTileType InTileType, UStaticMesh* Mesh, TConstArrayView<float> CustomData);
+
+	/** Shows and hides the actor as it leaves and goes back to the grid's pool */
+	void ActivateTile();
+	void DeactivateTile();
+
+	bool IsTileActive() const { return bTileActive; }
+
 protected:
+	UFUNCTION(BlueprintImplementableEvent, Category = "Tile")
+	void OnTilePromoted();
+
+	/** The tile's instance is drawn again once this returns, anything the actor did to look different has to be undone */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Tile")
+	void OnTileDemoted();
+
+	bool bTileActive = false;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Tile")
 	EHexTileType TileType = EHexTileType::INVALID;
@@ -0,0 +1,219 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HexTile.h"
+#include "HexLayout.h"
+
+enum class EHexTileFlags : uint8
+{
+	None = 0,
+	Valid = 1 << 0,
+};
+ENUM_CLASS_FLAGS(EHexTileFlags);
+
+// What the store needs to know about each biome of its grid, tiles only keep the biome index
+struct FHexTileBiome
+{
+	EHexTileType TileType = EHexTileType::INVALID;
+
+	// HISM drawing the biome, biomes sharing a mesh share the slot and its instance indices
+	uint8 MeshSlot = 0;
+};
+
+/**
+ * Structure-of-arrays tile storage for one hex grid, keyed by odd-row offset coordinates.
+ * Tiles live in fixed ChunkSize x ChunkSize pages so streamed chunks can be added and dropped,
+ * a tile index stays valid until its chunk is removed. Eight bytes per tile, plus four per HISM instance
+ * for the instance to tile lookup.
+ * Positions are never stored. Local locations are worked out from the integer tile coordinates relative to an
+ * anchor tile, so they stay small near the anchor however far the grid reaches.
+ * Only the game thread writes. Chunks are added and removed, and tiles set, removed, raised or retyped in place
+ * (runtime edits included), so a read off the game thread must not overlap any of those. Workers should read
+ * copies taken on the game thread, or run while the game thread waits on them.
+ */
+class CONTRACTRENEWED_API FHexTileStore
+{
+public:
+	static constexpr int32 NumDirections = HexLayout::NumDirections;
+
+	/** Drops every chunk. HeightScale is the largest absolute height the int16 heights can represent */
+	void Reset(int32 InChunkSize, float InHeightScale, TConstArrayView<FHexTileBiome> InBiomes);
+
+	/** World placement of the grid, Origin is the centre of InAnchorTile. The anchor must come from MakeAnchorTile */
+	void SetWorldLayout(const FVector& InOrigin, const FHexSpacing& InSpacing, const FIntPoint& InAnchorTile = FIntPoint::ZeroValue);
+
+	/**
+	 * Rounds a tile down to even coordinates. Offsets from such a tile don't depend on the half tile shift of odd rows,
+	 * so locations relative to it are plain translations of locations relative to tile (0, 0).
+	 */
+	static FIntPoint MakeAnchorTile(const FIntPoint& TileCoord) { return FIntPoint(TileCoord.X & ~1, TileCoord.Y & ~1); }
+
+	/** How far above the tile height the top of each mesh slot's tile mesh sits, indexed by mesh slot. Reset zeroes them */
+	void SetMeshSlotTops(TConstArrayView<float> InMeshSlotTops);
+
+	const FVector& GetOrigin() const { return Origin; }
+	const FIntPoint& GetAnchorTile() const { return AnchorTile; }
+	int32 GetChunkSize() const { return ChunkSize; }
+	float GetHeightScale() const { return HeightScale; }
+	const FHexSpacing& GetSpacing() const { return Spacing; }
+	TConstArrayView<FHexTileBiome> GetBiomes() const { return BiomeInfos; }
+	int32 GetTilesPerChunk() const { return ChunkSize * ChunkSize; }
+	FIntPoint GetChunkCoord(const FIntPoint& TileCoord) const;
+
+	/** Offset of a tile from the first tile of its chunk */
+	int32 GetLocalIndex(const FIntPoint& TileCoord) const;
+
+	/** Tile chunk geometry is built around, the first tile of the chunk rounded by MakeAnchorTile */
+	FIntPoint GetChunkOriginTile(const FIntPoint& ChunkCoord) const { return MakeAnchorTile(ChunkCoord * ChunkSize); }
+
+	/** Centre of the chunk's origin tile relative to the anchor, in double precision so far chunks line up exactly */
+	FVector GetChunkLocalOrigin(const FIntPoint& ChunkCoord) const;
+
+	/** Adds an empty chunk and returns the index of its first tile, every tile starts without the Valid flag */
+	int32 AddChunk(const FIntPoint& ChunkCoord);
+	bool RemoveChunk(const FIntPoint& ChunkCoord);
+	bool HasChunk(const FIntPoint& ChunkCoord) const { return ChunkSlots.Contains(ChunkCoord); }
+	int32 GetNumChunks() const { return ChunkSlots.Num(); }
+	void GetChunkCoords(TArray<FIntPoint>& OutChunkCoords) const;
+
+	/** Index of the first tile of a chunk, INDEX_NONE when it isn't loaded */
+	int32 FindChunkBase(const FIntPoint& ChunkCoord) const;
+
+	/** Bumped by every change to the tiles: chunks added or removed, tiles set, removed, raised or retyped */
+	uint32 GetRevision() const { return Revision; }
+
+	/** Revision of the last change to a chunk's tiles. Chunks that aren't loaded report the last chunk removal */
+	uint32 GetChunkRevision(const FIntPoint& ChunkCoord) const;
+
+	/** Tile index for an offset coordinate, INDEX_NONE when the chunk isn't loaded or the tile was never set */
+	int32 FindTile(const FIntPoint& TileCoord) const;
+
+	/** Tile index of the neighbour in Direction (see HexLayout::Directions), INDEX_NONE if missing */
+	int32 FindNeighbour(int32 TileIndex, int32 Direction) const;
+
+	/** Tile whose hex contains WorldLocation on the grid plane, INDEX_NONE if that tile isn't loaded */
+	int32 FindTileAtLocation(const FVector& WorldLocation) const;
+
+	/** Offset coordinate of the hex containing WorldLocation, loaded or not */
+	FIntPoint WorldToTileCoord(const FVector& WorldLocation) const;
+
+	/** Tile drawn by an instance of the HISM in MeshSlot, INDEX_NONE for hidden or unknown instances */
+	int32 FindTileByInstance(uint8 MeshSlot, int32 InstanceIndex) const
+	{
+		if (!InstanceTiles.IsValidIndex(MeshSlot))
+			return INDEX_NONE;
+
+		const TArray<int32>& Owners = InstanceTiles[MeshSlot];
+		return Owners.IsValidIndex(InstanceIndex) ? Owners[InstanceIndex] : INDEX_NONE;
+	}
+
+	FIntPoint GetTileCoord(int32 TileIndex) const;
+
+	/** World position of the tile centre, Z is the tile height */
+	FVector GetTileLocation(int32 TileIndex) const;
+
+	/** Tile centre relative to the anchor tile, where the grid's HISM instance for the tile sits */
+	FVector GetTileLocalLocation(int32 TileIndex) const;
+
+	/** Centre of any tile relative to the anchor tile, at the given height */
+	FVector GetLocalLocation(const FIntPoint& TileCoord, float Height = 0.f) const;
+
+	/** World Z of the top of the tile, what a character standing on it stands on */
+	float GetGroundHeight(int32 TileIndex) const { return Origin.Z + GetHeight(TileIndex) + MeshSlotTops[GetMeshSlot(TileIndex)]; }
+
+	/**
+	 * Ground height under each world X/Y not yet flagged in InOutFound, found ones are written to OutHeights and flagged.
+	 * Returns how many this store resolved. No physics involved, only the tile data is read.
+	 */
+	int32 GetGroundHeights(TConstArrayView<FVector2D> Locations, TArrayView<float> OutHeights, TBitArray<>& InOutFound) const;
+	static FIntPoint GetNeighbourCoord(const FIntPoint& TileCoord, int32 Direction);
+
+	bool IsValidTile(int32 TileIndex) const
+	{
+		return Flags.IsValidIndex(TileIndex) && EnumHasAnyFlags(Flags[TileIndex], EHexTileFlags::Valid);
+	}
+
+	void SetTile(int32 TileIndex, float Height, uint8 Biome, int32 InstanceIndex);
+
+	/** Clears the Valid flag and unlinks the tile's instance, the chunk stays loaded */
+	void RemoveTile(int32 TileIndex);
+
+	float GetHeight(int32 TileIndex) const { return Heights[TileIndex] * HeightScale / MAX_int16; }
+
+	/** Heights beyond HeightScale are clamped, callers that must not lose an edit check against GetHeightScale first */
+	void SetHeight(int32 TileIndex, float Height)
+	{
+		Heights[TileIndex] = QuantizeHeight(Height);
+		TouchChunk(TileIndex);
+	}
+
+	/** True when Height quantizes to the stored height, i.e. rewriting it would change nothing */
+	bool IsSameHeight(int32 TileIndex, float Height) const { return Heights[TileIndex] == QuantizeHeight(Height); }
+
+	uint8 GetBiome(int32 TileIndex) const { return Biomes[TileIndex]; }
+	void SetBiome(int32 TileIndex, uint8 Biome);
+
+	EHexTileType GetType(int32 TileIndex) const { return BiomeInfos[Biomes[TileIndex]].TileType; }
+	uint8 GetMeshSlot(int32 TileIndex) const { return BiomeInfos[Biomes[TileIndex]].MeshSlot; }
+
+	int32 GetInstanceIndex(int32 TileIndex) const { return InstanceIndices[TileIndex]; }
+	void SetInstanceIndex(int32 TileIndex, int32 InstanceIndex);
+
+	EHexTileFlags GetFlags(int32 TileIndex) const { return Flags[TileIndex]; }
+	void AddFlags(int32 TileIndex, EHexTileFlags InFlags) { EnumAddFlags(Flags[TileIndex], InFlags); }
+	void RemoveFlags(int32 TileIndex, EHexTileFlags InFlags) { EnumRemoveFlags(Flags[TileIndex], InFlags); }
+
+	/** Calls Func(TileIndex, TileCoord) for every valid tile */
+	template <typename FuncType>
+	void ForEachTile(FuncType&& Func) const
+	{
+		for (const TPair<FIntPoint, int32>& Pair : ChunkSlots)
+		{
+			const int32 Base = Pair.Value * GetTilesPerChunk();
+			for (int32 Local = 0; Local < GetTilesPerChunk(); ++Local)
+			{
+				if (EnumHasAnyFlags(Flags[Base + Local], EHexTileFlags::Valid))
+				{
+					Func(Base + Local, Pair.Key * ChunkSize + FIntPoint(Local % ChunkSize, Local / ChunkSize));
+				}
+			}
+		}
+	}
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	int16 QuantizeHeight(float Height) const;
+
+	void TouchChunk(int32 TileIndex) { SlotRevisions[TileIndex / GetTilesPerChunk()] = ++Revision; }
+
+	void LinkInstance(int32 TileIndex);
+	void UnlinkInstance(int32 TileIndex);
+
+	int32 ChunkSize = 16;
+	float HeightScale = 1.f;
+
+	FVector Origin = FVector::ZeroVector;
+	FIntPoint AnchorTile = FIntPoint::ZeroValue;
+	FHexSpacing Spacing;
+
+	TMap<FIntPoint, int32> ChunkSlots;
+	TArray<FIntPoint> SlotChunkCoords;
+	TArray<int32> FreeSlots;
+
+	uint32 Revision = 0;
+	uint32 RemovedChunkRevision = 0;
+	TArray<uint32> SlotRevisions;
+
+	// One entry per tile, TilesPerChunk entries per slot
+	TArray<int16> Heights;
+	TArray<uint8> Biomes;
+	TArray<int32> InstanceIndices;
+	TArray<EHexTileFlags> Flags;
+
+	TArray<FHexTileBiome> BiomeInfos;
+	TArray<float> MeshSlotTops;
+
+	// Reverse of InstanceIndices, indexed by HISM instance, one array per mesh slot since each slot has its own HISM
+	TArray<TArray<int32>> InstanceTiles;
+};